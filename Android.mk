@@ -15,6 +15,7 @@ LOCAL_SRC_FILES := card.cpp \
 				libduel.cpp \
 				libeffect.cpp \
 				libgroup.cpp \
+				lua_allocator.cpp \
 				ocgapi.cpp \
 				operations.cpp \
 				playerop.cpp \
@@ -1,6 +1,6 @@
 /*
  * Copyright (c) 2020, Dylam De La Torre, (DyXel)
- * Copyright (c) 2020-2024, Edoardo Lolletti (edo9300) <edoardo762@gmail.com>
+ * Copyright (c) 2020-2026, Edoardo Lolletti (edo9300) <edoardo762@gmail.com>
  *
  * SPDX-License-Identifier: AGPL-3.0-or-later
  */
@@ -41,6 +41,42 @@ public:
 		return result;
 	}
 
+	// Uniform integer in [0, range), range must be greater than 0.
+	// Uses Lemire's multiply-shift reduction, the 64 bit modulo is only computed
+	// in the rare case the draw could be biased.
+	constexpr ResultType bounded(uint64_t range) noexcept
+	{
+		uint64_t low = 0;
+		uint64_t result = mul(operator()(), range, low);
+		if(low < range)
+		{
+			const uint64_t threshold = (0 - range) % range;
+			while(low < threshold)
+				result = mul(operator()(), range, low);
+		}
+		return result;
+	}
+
+	// Uniform integers in [0, range1) and [0, range2) from a single draw
+	// (Brackett-Rozinsky & Lemire, "Batched Ranged Random Integer Generation"),
+	// range1 * range2 must be greater than 0 and must not overflow.
+	constexpr void bounded_pair(uint64_t range1, uint64_t range2, uint64_t& result1, uint64_t& result2) noexcept
+	{
+		const uint64_t product = range1 * range2;
+		uint64_t low = 0;
+		result1 = mul(operator()(), range1, low);
+		result2 = mul(low, range2, low);
+		if(low < product)
+		{
+			const uint64_t threshold = (0 - product) % product;
+			while(low < threshold)
+			{
+				result1 = mul(operator()(), range1, low);
+				result2 = mul(low, range2, low);
+			}
+		}
+	}
+
 	// NOTE: std::shuffle requires these.
 	using result_type = ResultType;
 	static constexpr ResultType min() noexcept { return ResultType(0U); }
@@ -52,6 +88,19 @@ private:
 	{
 		return (x << k) | (x >> (64 - k));
 	}
+
+	// 64x64 -> 128 bit multiplication, returns the high half and stores the low one in low.
+	static constexpr uint64_t mul(const uint64_t a, const uint64_t b, uint64_t& low)
+	{
+		const uint64_t a_lo = a & 0xFFFFFFFF, a_hi = a >> 32;
+		const uint64_t b_lo = b & 0xFFFFFFFF, b_hi = b >> 32;
+		const uint64_t lo_lo = a_lo * b_lo;
+		const uint64_t lo_hi = a_lo * b_hi;
+		const uint64_t hi_lo = a_hi * b_lo;
+		const uint64_t mid = (lo_lo >> 32) + (lo_hi & 0xFFFFFFFF) + (hi_lo & 0xFFFFFFFF);
+		low = (mid << 32) | (lo_lo & 0xFFFFFFFF);
+		return a_hi * b_hi + (lo_hi >> 32) + (hi_lo >> 32) + (mid >> 32);
+	}
 };
 
 } // namespace RNG
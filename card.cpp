@@ -62,6 +62,17 @@ template<typename T>
 static constexpr bool has_valid_property_val(T val) {
 	return val != ~T();
 }
+// the card in the zone represented by bit of a linked zone mask relative to playerid
+static card* get_linked_zone_card(field* pfield, uint8_t playerid, uint32_t bit) {
+	if(bit >= 16) {
+		playerid = 1 - playerid;
+		bit -= 16;
+	}
+	const auto& pinfo = pfield->player[playerid];
+	if(bit < 8)
+		return bit < pinfo.list_mzone.size() ? pinfo.list_mzone[bit] : nullptr;
+	return pinfo.list_szone[bit - 8];
+}
 void card_state::set0xff() {
 	set_max_property_val(code);
 	set_max_property_val(code2);
@@ -2013,6 +2024,8 @@ int32_t card::is_link_marker(uint32_t dir) {
 	return (int32_t)(get_link_marker() & dir);
 }
 uint32_t card::get_linked_zone(bool free) {
+	if(!(data.type & TYPE_LINK) && assume.empty() && pduel->game_field->effects.add_type_count == 0)
+		return 0;
 	if(!(get_type() & TYPE_LINK) || !(current.location & LOCATION_ONFIELD) || get_status(STATUS_SUMMONING | STATUS_SPSUMMON_STEP))
 		return 0;
 	int32_t zones = 0;
@@ -2129,19 +2142,18 @@ void card::get_linked_cards(card_set* cset, uint32_t zones) {
 	}
 }
 uint32_t card::get_mutual_linked_zone() {
+	if(!(data.type & TYPE_LINK))
+		return 0;
 	uint32_t linked_zone = get_linked_zone();
 	if(!linked_zone)
 		return 0;
-	int32_t zones = 0;
-	card_set cset;
-	get_linked_cards(&cset, linked_zone);
-	for(auto& pcard : cset) {
-		auto zone = pcard->get_linked_zone();
-		uint32_t is_szone = pcard->current.location == LOCATION_SZONE ? 8 : 0;
-		uint32_t is_player = (current.controler == pcard->current.controler) ? 0 : 16;
-		if(is_mutual_linked(pcard, linked_zone, zone)) {
-			zones |= 1 << (pcard->current.sequence + is_szone + is_player);
-		}
+	uint32_t zones = 0;
+	for(uint32_t i = 0; i < 32; ++i) {
+		if(!(linked_zone & (1u << i)))
+			continue;
+		card* pcard = get_linked_zone_card(pduel->game_field, current.controler, i);
+		if(pcard && is_mutual_linked(pcard, linked_zone, pcard->get_linked_zone()))
+			zones |= 1u << i;
 	}
 	return zones;
 }
@@ -2157,11 +2169,17 @@ void card::get_mutual_linked_cards(card_set* cset) {
 int32_t card::is_link_state() {
 	if(!(current.location & LOCATION_ONFIELD))
 		return FALSE;
-	card_set cset;
-	get_linked_cards(&cset);
-	if(cset.size())
-		return TRUE;
 	int32_t p = current.controler;
+	if((data.type & TYPE_LINK) && !get_status(STATUS_SUMMONING | STATUS_SPSUMMON_STEP)) {
+		uint32_t linked_zone = get_linked_zone();
+		for(uint32_t i = 0; linked_zone && i < 32; ++i) {
+			if(!(linked_zone & (1u << i)))
+				continue;
+			card* pcard = get_linked_zone_card(pduel->game_field, p, i);
+			if(pcard && (pcard->current.location == LOCATION_MZONE || (pcard->get_type() & TYPE_LINK)))
+				return TRUE;
+		}
+	}
 	uint32_t is_szone = current.location == LOCATION_SZONE ? 8 : 0;
 	uint32_t linked_zone = pduel->game_field->get_linked_zone(p, false, true);
 	if((linked_zone >> (current.sequence + is_szone)) & 1)
@@ -2429,7 +2447,10 @@ int32_t card::add_effect(effect* peffect) {
 	}
 	if (indexer.find(peffect) != indexer.end())
 		return 0;
-	card_set check_target = { this };
+	// cards whose disable status could be changed by the effect, kept as a single card
+	// or a pointer to an existing set to not allocate a set for every registered effect
+	card* check_card = this;
+	const card_set* check_cards = nullptr;
 	effect_container::iterator eit;
 	if (peffect->type & EFFECT_TYPE_SINGLE) {
 		if((peffect->code == EFFECT_SET_ATTACK || peffect->code == EFFECT_SET_BASE_ATTACK) && !peffect->is_flag(EFFECT_FLAG_SINGLE_RANGE)) {
@@ -2467,26 +2488,20 @@ int32_t card::add_effect(effect* peffect) {
 		eit = single_effect.emplace(peffect->code, peffect);
 	} else if (peffect->type & EFFECT_TYPE_EQUIP) {
 		eit = equip_effect.emplace(peffect->code, peffect);
-		if (equiping_target)
-			check_target = { equiping_target };
-		else
-			check_target.clear();
+		check_card = equiping_target;
 	} else if(peffect->type & EFFECT_TYPE_TARGET) {
 		eit = target_effect.emplace(peffect->code, peffect);
-		if(!effect_target_cards.empty())
-			check_target = effect_target_cards;
-		else
-			check_target.clear();
+		check_card = nullptr;
+		check_cards = &effect_target_cards;
 	} else if (peffect->type & EFFECT_TYPE_XMATERIAL) {
 		eit = xmaterial_effect.emplace(peffect->code, peffect);
-		if (overlay_target)
-			check_target = { overlay_target };
-		else
-			check_target.clear();
+		check_card = overlay_target;
 	} else if (peffect->type & EFFECT_TYPE_FIELD) {
 		eit = field_effect.emplace(peffect->code, peffect);
 	} else
 		return 0;
+	if(!(peffect->type & EFFECT_TYPE_FIELD))
+		pduel->game_field->count_adjust_effect(peffect->code, 1);
 	if(peffect->code == EFFECT_SELF_TOGRAVE)
 		pduel->game_field->core.global_flag |= GLOBALFLAG_SELF_TOGRAVE;
 	else if(peffect->code == EVENT_DETACH_MATERIAL)
@@ -2514,10 +2529,14 @@ int32_t card::add_effect(effect* peffect) {
 			|| (current.controler != PLAYER_NONE && ((peffect->range & LOCATION_HAND) && (peffect->type & EFFECT_TYPE_TRIGGER_O) && !(peffect->code & EVENT_PHASE))))
 			pduel->game_field->add_effect(peffect);
 	}
-	if (current.controler != PLAYER_NONE && !check_target.empty()) {
-		if(peffect->is_disable_related())
-			for(auto& target : check_target)
-				pduel->game_field->add_to_disable_check_list(target);
+	if (current.controler != PLAYER_NONE && (check_card || check_cards)) {
+		if(peffect->is_disable_related()) {
+			if(check_card)
+				pduel->game_field->add_to_disable_check_list(check_card);
+			else
+				for(auto& target : *check_cards)
+					pduel->game_field->add_to_disable_check_list(target);
+		}
 	}
 	if(peffect->is_flag(EFFECT_FLAG_OATH)) {
 		pduel->game_field->effects.oath.emplace(peffect, reason_effect);
@@ -2565,6 +2584,8 @@ void card::remove_effect(effect* peffect) {
 }
 void card::remove_effect(effect* peffect, effect_container::iterator it) {
 	card_set check_target = { this };
+	if(!(peffect->type & EFFECT_TYPE_FIELD))
+		pduel->game_field->count_adjust_effect(it->first, -1);
 	if (peffect->type & EFFECT_TYPE_SINGLE) {
 		single_effect.erase(it);
 	} else if (peffect->type & EFFECT_TYPE_EQUIP) {
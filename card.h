@@ -154,6 +154,9 @@ public:
 	uint8_t attack_all_target{};
 	uint8_t attack_controler{};
 	uint32_t cardid{};
+	bool pending_initial_effect{};
+	// first of the field ids reserved for the deferred initial_effect
+	uint32_t lazy_field_id{};
 	uint32_t fieldid{};
 	uint32_t fieldid_r{};
 	uint16_t turnid{};
@@ -513,6 +513,10 @@
 #define DUEL_TCG_FAST_EFFECT_IGNITION 0x400000000
 #define DUEL_EXTRA_DECK_RITUAL 0x800000000
 #define DUEL_NORMAL_SUMMON_FACEUP_DEF 0x1000000000
+#define DUEL_LAZY_CARD_INIT 0x2000000000
+#define DUEL_SERIALIZABLE 0x4000000000
+#define DUEL_FAST_RNG 0x8000000000
+#define DUEL_COMPACT_MESSAGES 0x10000000000
 #define DUEL_MODE_SPEED        (DUEL_3_COLUMNS_FIELD | DUEL_NO_MAIN_PHASE_2 | DUEL_TRAP_MONSTERS_NOT_USE_ZONE | DUEL_TRIGGER_ONLY_IN_LOCATION)
 #define DUEL_MODE_RUSH         (DUEL_3_COLUMNS_FIELD | DUEL_NO_MAIN_PHASE_2 | DUEL_NO_STANDBY_PHASE | DUEL_1ST_TURN_DRAW | DUEL_INVERTED_QUICK_PRIORITY | DUEL_DRAW_UNTIL_5 | DUEL_NO_HAND_LIMIT | DUEL_UNLIMITED_SUMMONS | DUEL_TRAP_MONSTERS_NOT_USE_ZONE | DUEL_TRIGGER_ONLY_IN_LOCATION | DUEL_EXTRA_DECK_RITUAL)
 #define DUEL_MODE_MR1          (DUEL_OCG_OBSOLETE_IGNITION | DUEL_1ST_TURN_DRAW | DUEL_1_FACEUP_FIELD | DUEL_SPSUMMON_ONCE_OLD_NEGATE | DUEL_RETURN_TO_DECK_TRIGGERS | DUEL_CANNOT_SUMMON_OATH_OLD)
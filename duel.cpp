@@ -4,31 +4,73 @@
  *
  * SPDX-License-Identifier: AGPL-3.0-or-later
  */
+#include <algorithm> //std::min
 #include <array>
 #include <cstring> //std::memcpy
+#include <utility> //std::exchange
 #include "card.h"
 #include "duel.h"
 #include "effect.h"
 #include "field.h"
 #include "interpreter.h"
 
+// ocgapi_messages.h can't include common.h, its message types are checked against it here
+static_assert(Messages::HINT == MSG_HINT && Messages::WIN == MSG_WIN && Messages::SHUFFLE_DECK == MSG_SHUFFLE_DECK
+			  && Messages::REVERSE_DECK == MSG_REVERSE_DECK && Messages::NEW_PHASE == MSG_NEW_PHASE
+			  && Messages::FIELD_DISABLED == MSG_FIELD_DISABLED && Messages::SUMMONED == MSG_SUMMONED
+			  && Messages::SPSUMMONED == MSG_SPSUMMONED && Messages::FLIPSUMMONED == MSG_FLIPSUMMONED
+			  && Messages::CHAIN_SOLVING == MSG_CHAIN_SOLVING && Messages::CHAIN_SOLVED == MSG_CHAIN_SOLVED
+			  && Messages::CHAIN_END == MSG_CHAIN_END && Messages::CHAIN_NEGATED == MSG_CHAIN_NEGATED
+			  && Messages::CHAIN_DISABLED == MSG_CHAIN_DISABLED && Messages::DAMAGE == MSG_DAMAGE
+			  && Messages::RECOVER == MSG_RECOVER && Messages::LPUPDATE == MSG_LPUPDATE
+			  && Messages::PAY_LPCOST == MSG_PAY_LPCOST && Messages::ATTACK_DISABLED == MSG_ATTACK_DISABLED
+			  && Messages::DAMAGE_STEP_START == MSG_DAMAGE_STEP_START && Messages::DAMAGE_STEP_END == MSG_DAMAGE_STEP_END,
+			  "Message types differ between ocgapi_messages.h and common.h");
+
 duel::duel(const OCG_DuelOptions& options, bool& valid_lua_lib) :
+	fast_rng((options.flags & DUEL_FAST_RNG) != 0),
+	compact_messages((options.flags & DUEL_COMPACT_MESSAGES) != 0),
+	group_collection_threshold(options.gc.groupThreshold != 0 ? options.gc.groupThreshold : 2048),
+	process_step_budget(options.budget.steps),
+	next_group_collection(group_collection_threshold),
 	random({ options.seed[0], options.seed[1], options.seed[2], options.seed[3] }),
 	read_card_callback(options.cardReader), read_script_callback(options.scriptReader),
 	handle_message_callback(options.logHandler), read_card_done_callback(options.cardReaderDone),
 	read_card_payload(options.payload1), read_script_payload(options.payload2),
 	handle_message_payload(options.payload3), read_card_done_payload(options.payload4)
 {
+	/////zdiy/////
+	// adopted before the state is created, so that it's released even if that fails
+	cards_data = (std::unordered_map<uint32_t, std::vector<void*>*>*)options.payload5;
+	/////zdiy/////
+	create_state(options, valid_lua_lib);
+}
+duel::~duel() {
+	release_state();
+	/////zdiy/////
+	release_cards_data();
+	/////zdiy/////
+}
+/////zdiy/////
+void duel::release_cards_data() {
+	if(!cards_data)
+		return;
+	for(auto& [code, data] : *cards_data) {
+		delete static_cast<std::vector<uint32_t>*>(data->at(0));
+		delete data;
+	}
+	delete cards_data;
+	cards_data = nullptr;
+}
+/////zdiy/////
+void duel::create_state(const OCG_DuelOptions& options, bool& valid_lua_lib) {
 	lua = new interpreter(this, options, valid_lua_lib);
 	if(!valid_lua_lib)
 		return;
 	game_field = new field(this, options);
 	game_field->temp_card = new_card(0);
-	/////zdiy/////
-	cards_data = (std::unordered_map<uint32_t, std::vector<void*>*>*)options.payload5;
-	/////zdiy/////
 }
-duel::~duel() {
+void duel::release_state() {
 	for(auto& pcard : cards)
 		delete pcard;
 	for(auto& pgroup : groups) {
@@ -39,17 +81,64 @@ duel::~duel() {
 		delete peffect;
 	delete game_field;
 	delete lua;
-	/////zdiy/////
-	for (auto iter = cards_data->begin(); iter != cards_data->end(); iter++) {
-		delete (iter->second)->at(0);
-		delete iter->second;
-	}
-	delete cards_data;
-	/////zdiy/////
+	game_field = nullptr;
+	lua = nullptr;
 	// TODO: this should actually be an assertion as no group should outlive the lua state
 	for(auto& pgroup : groups)
 		delete pgroup;
 }
+/*
+	Brings the duel back to the state of a freshly created one with the new options.
+	The lua state is recreated as well, as scripts are free to keep state in their globals
+	(e.g. the global checks registered once per duel), but the card data cache and the
+	compiled scripts are kept, so the new duel doesn't have to read and parse them again.
+*/
+void duel::reset(const OCG_DuelOptions& options, bool& valid_lua_lib) {
+	release_state();
+	cards.clear();
+	assumes.clear();
+	groups.clear();
+	effects.clear();
+	uncopy.clear();
+	buff.clear();
+	query_buffer.clear();
+	messages.clear();
+	loaded_scripts.clear();
+	journal.clear();
+	if(read_card_callback != options.cardReader || read_card_payload != options.payload1)
+		data_cache.clear();
+	if(read_script_callback != options.scriptReader || read_script_payload != options.payload2)
+		script_cache.clear();
+	// a duel that is reset is likely to be reset again, start keeping the compiled scripts
+	cache_scripts = true;
+	script_cache_target = nullptr;
+	script_cache_loads = 0;
+	group_collection_threshold = options.gc.groupThreshold != 0 ? options.gc.groupThreshold : 2048;
+	next_group_collection = group_collection_threshold;
+	process_step_budget = options.budget.steps;
+	groups_reclaimed = 0;
+	fast_rng = (options.flags & DUEL_FAST_RNG) != 0;
+	compact_messages = (options.flags & DUEL_COMPACT_MESSAGES) != 0;
+	for(auto& previous : previous_messages)
+		previous.clear();
+	random = RNG::Xoshiro256StarStar({ options.seed[0], options.seed[1], options.seed[2], options.seed[3] });
+	read_card_callback = options.cardReader;
+	read_script_callback = options.scriptReader;
+	handle_message_callback = options.logHandler;
+	read_card_done_callback = options.cardReaderDone;
+	read_card_payload = options.payload1;
+	read_script_payload = options.payload2;
+	handle_message_payload = options.payload3;
+	read_card_done_payload = options.payload4;
+	/////zdiy/////
+	auto* new_cards_data = (std::unordered_map<uint32_t, std::vector<void*>*>*)options.payload5;
+	if(cards_data != new_cards_data) {
+		release_cards_data();
+		cards_data = new_cards_data;
+	}
+	/////zdiy/////
+	create_state(options, valid_lua_lib);
+}
 #if defined(__GNUC__) || defined(__clang_analyzer__)
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wmissing-field-initializers"
@@ -82,13 +171,13 @@ void duel::clear() {
 #ifdef __GNUC__
 #pragma GCC diagnostic pop
 #endif
-card* duel::new_card(uint32_t code) {
+card* duel::new_card(uint32_t code, bool lazy_init) {
 	card* pcard = new card(this);
 	cards.insert(pcard);
 	if(code)
 		pcard->data = read_card(code);
 	pcard->data.code = code;
-	lua->register_card(pcard);
+	lua->register_card(pcard, lazy_init);
 	return pcard;
 }
 effect* duel::new_effect() {
@@ -102,23 +191,109 @@ void duel::delete_card(card* pcard) {
 	delete pcard;
 }
 void duel::delete_group(group* pgroup) {
+	lua->unregister_group(pgroup);
 	groups.erase(pgroup);
 	delete pgroup;
+	++groups_reclaimed;
+	next_group_collection = std::min(next_group_collection, groups.size() + group_collection_threshold);
 }
 void duel::delete_effect(effect* peffect) {
 	lua->unregister_effect(peffect);
 	effects.erase(peffect);
 	delete peffect;
 }
-void duel::generate_buffer() {
+int duel::read_script(const char* name) {
+	if(!cache_scripts)
+		return read_script_callback(read_script_payload, this, name);
+	auto [it, inserted] = script_cache.try_emplace(name);
+	auto& entry = it->second;
+	if(!inserted && (!entry.cacheable || !entry.bytecode.empty())) {
+		auto* previous = std::exchange(script_cache_target, nullptr);
+		const auto ret = entry.cacheable ?
+			lua->load_script(entry.bytecode.data(), static_cast<int>(entry.bytecode.size()), name) :
+			read_script_callback(read_script_payload, this, name);
+		script_cache_target = previous;
+		return ret;
+	}
+	// the cached chunk replaces the whole callback, so it's only kept if the callback
+	// loaded exactly one chunk, anything else (e.g. a reader loading a shared utility
+	// before the script itself) is always read again
+	auto* previous = std::exchange(script_cache_target, &entry.bytecode);
+	const auto previous_loads = std::exchange(script_cache_loads, 0);
+	const auto ret = read_script_callback(read_script_payload, this, name);
+	const auto loads = std::exchange(script_cache_loads, previous_loads);
+	script_cache_target = previous;
+	if(!ret) {
+		script_cache.erase(name);
+	} else if(loads != 1) {
+		entry.bytecode.clear();
+		entry.cacheable = false;
+	}
+	return ret;
+}
+// returns whether any message was generated
+bool duel::generate_buffer() {
+	bool generated = false;
 	for(auto& message : messages) {
 		uint32_t size = static_cast<uint32_t>(message.data.size());
 		if(size == 0)
 			continue;
+		generated = true;
+		if(message_handler) {
+			message_handler(message_payload, message.data.data(), size);
+			continue;
+		}
+		if(compact_messages) {
+			write_compact_message(message.data);
+			continue;
+		}
 		write_buffer(&size, sizeof(size));
 		write_buffer(message.data.data(), size);
 	}
 	messages.clear();
+	return generated;
+}
+/*
+	Messages of the same type tend to repeat most of their bytes (locations, card codes, players),
+	so with DUEL_COMPACT_MESSAGES each one is written as the differences from the previous message
+	of its type: its length as a varint, its type, then pairs of varints for the number of bytes
+	equal to the ones at the same position in the previous message and the number of bytes that
+	follow as they are, until the length is covered. See Messages::CompactStreamDecoder.
+*/
+void duel::write_compact_message(const std::vector<uint8_t>& message) {
+	auto write_varint = [this](uint32_t value) {
+		uint8_t bytes[5];
+		size_t count = 0;
+		do {
+			bytes[count] = static_cast<uint8_t>(value & 0x7f);
+			value >>= 7;
+			if(value)
+				bytes[count] |= 0x80;
+			++count;
+		} while(value);
+		write_buffer(bytes, count);
+	};
+	auto& previous = previous_messages[message[0]];
+	const size_t size = message.size();
+	const auto matches = [&](size_t i) {
+		return i < size && i < previous.size() && message[i] == previous[i];
+	};
+	write_varint(static_cast<uint32_t>(size));
+	write_buffer(message.data(), 1);
+	size_t i = 1;
+	while(i < size) {
+		const size_t copy_start = i;
+		while(i < size && matches(i))
+			++i;
+		const size_t literal_start = i;
+		// a copy shorter than 3 bytes costs as much as keeping those bytes in the literal
+		while(i < size && !(matches(i) && matches(i + 1) && matches(i + 2)) && !(matches(i) && i + 1 == size))
+			++i;
+		write_varint(static_cast<uint32_t>(literal_start - copy_start));
+		write_varint(static_cast<uint32_t>(i - literal_start));
+		write_buffer(message.data() + literal_start, i - literal_start);
+	}
+	previous = message;
 }
 void duel::restore_assumes() {
 	for(auto& pcard : assumes)
@@ -145,6 +320,8 @@ void duel::set_response(const void* resp, size_t len) {
 int32_t duel::get_next_integer(int32_t l, int32_t h) {
 	assert(l <= h);
 	const uint64_t range = int64_t(h) - int64_t(l) + 1;
+	if(fast_rng)
+		return static_cast<int32_t>(random.bounded(range) + l);
 	const uint64_t lim = random.max() % range;
 	uint64_t n;
 	do {
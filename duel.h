@@ -7,16 +7,19 @@
 #ifndef DUEL_H_
 #define DUEL_H_
 
+#include <array>
 #include <deque>
 #include <set>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
-#include <utility> //std::forward
+#include <utility> //std::forward, std::swap
 #include <vector>
 #include "common.h"
 #include "group.h"
 #include "interpreter.h"
 #include "lua_obj.h"
+#include "ocgapi_messages.h"
 #include "ocgapi_types.h"
 #include "RNG/Xoshiro256.hpp"
 
@@ -80,10 +83,19 @@ public:
 	std::unordered_set<group*> groups;
 	std::unordered_set<effect*> effects;
 	std::unordered_set<effect*> uncopy;
+	// DUEL_FAST_RNG, bounded integers are drawn with Lemire's reduction instead of the rejection loop
+	bool fast_rng;
+	// DUEL_COMPACT_MESSAGES, the buffer holds the messages encoded against the previous one of the same type
+	bool compact_messages;
+	std::array<std::vector<uint8_t>, 256> previous_messages;
+	size_t group_collection_threshold;
+	uint32_t process_step_budget;
+	size_t next_group_collection;
+	uint64_t groups_reclaimed{};
 
 	std::unordered_map<uint32_t, card_data> data_cache;
 	/////zdiy/////
-	std::unordered_map<uint32_t, std::vector<void*>*>* cards_data;
+	std::unordered_map<uint32_t, std::vector<void*>*>* cards_data{};
 	/////zdiy/////
 
 	enum class SCRIPT_LOAD_STATUS : uint8_t {
@@ -94,13 +106,35 @@ public:
 	};
 
 	std::unordered_map<uint32_t/* hashed string */, SCRIPT_LOAD_STATUS> loaded_scripts;
+	struct cached_script {
+		std::string bytecode;
+		// false if the script reader loaded more or less than one chunk for this name
+		bool cacheable{ true };
+	};
+	// compiled scripts kept across resets, indexed by the name passed to read_script
+	std::unordered_map<std::string, cached_script> script_cache;
+	// entry of script_cache where the chunk loaded by load_script should be dumped
+	std::string* script_cache_target{};
+	// chunks loaded by load_script while script_cache_target was set
+	uint32_t script_cache_loads{};
+	bool cache_scripts{ false };
+	// calls made through the api that changed the duel state, only kept with DUEL_SERIALIZABLE
+	std::vector<uint8_t> journal;
+	// number of api calls currently running that are recorded in the journal
+	uint32_t journal_depth{};
+	// set with OCG_DuelSetHandlers, when there's a message handler the messages are passed to it instead of buff
+	OCG_MessageHandler message_handler{};
+	void* message_payload{};
+	OCG_AwaitingHandler awaiting_handler{};
+	void* awaiting_payload{};
 	
 	duel() = delete;
 	explicit duel(const OCG_DuelOptions& options, bool& valid_lua_lib);
 	~duel();
 	void clear();
+	void reset(const OCG_DuelOptions& options, bool& valid_lua_lib);
 	
-	card* new_card(uint32_t code);
+	card* new_card(uint32_t code, bool lazy_init = false);
 	template<typename... Args>
 	owned_lua<group> new_group(Args&&... args) {
 		auto pgroup = [&]() {
@@ -109,8 +143,11 @@ public:
 			lua->register_group(pgroup);
 			return owned_lua<group>{pgroup};
 		}();
-		if(groups.size() > 2048) {
+		// lua doesn't know about the memory held by the groups, so force
+		// some collection work if too many were created since the last one
+		if(groups.size() > next_group_collection) {
 			lua->collect();
+			next_group_collection = groups.size() + group_collection_threshold;
 		}
 		return pgroup;
 	}
@@ -119,20 +156,47 @@ public:
 	void delete_group(group* pgroup);
 	void delete_effect(effect* peffect);
 	void restore_assumes();
-	void generate_buffer();
+	bool generate_buffer();
 	void write_buffer(const void* data, size_t size);
+	void write_compact_message(const std::vector<uint8_t>& message);
 	void clear_buffer();
 	void set_response(const void* resp, size_t len);
 	int32_t get_next_integer(int32_t l, int32_t h);
+	// Fisher-Yates shuffle of the first size elements, DUEL_FAST_RNG only:
+	// every draw of the rng provides the indices of two swaps
+	template<typename T>
+	void shuffle(T first, size_t size) {
+		for(; size > 2; size -= 2) {
+			uint64_t r1, r2;
+			random.bounded_pair(size, size - 1, r1, r2);
+			std::swap(first[size - 1], first[r1]);
+			std::swap(first[size - 2], first[r2]);
+		}
+		if(size == 2)
+			std::swap(first[1], first[random.bounded(2)]);
+	}
 	duel_message* new_message(uint8_t message);
+	// writes a whole message with a fixed layout, the values are converted to the types of its schema
+	template<uint8_t message, typename... Args>
+	void write_message(Args... args) {
+		static_assert(sizeof...(Args) == Messages::Schema<message>::count, "Wrong number of fields for the message");
+		Messages::write_fields<message>(*new_message(message), std::index_sequence_for<Args...>{}, args...);
+	}
 	const card_data& read_card(uint32_t code);
 	inline void handle_message(const char* message, OCG_LogTypes type) {
 		handle_message_callback(handle_message_payload, message, type);
 	}
-	inline int read_script(const char* name) {
-		return read_script_callback(read_script_payload, this, name);
+	inline void set_log_handler(OCG_LogHandler callback, void* payload) {
+		handle_message_callback = callback;
+		handle_message_payload = payload;
 	}
+	int read_script(const char* name);
 private:
+	void release_state();
+	void create_state(const OCG_DuelOptions& options, bool& valid_lua_lib);
+	/////zdiy/////
+	void release_cards_data();
+	/////zdiy/////
 	std::deque<duel_message> messages;
 	RNG::Xoshiro256StarStar random;
 	OCG_DataReader read_card_callback;
@@ -131,6 +131,9 @@ void field::add_card(uint8_t playerid, card* pcard, uint8_t location, uint8_t se
 			pcard->sendto_param.position = POS_FACEDOWN_DEFENSE;
 		}
 	}
+	// a lazily initialized card is leaving the deck, register its effects before it reaches the new location
+	if(pcard->pending_initial_effect && location != LOCATION_DECK)
+		pduel->lua->run_initial_effect(pcard);
 	pcard->current.controler = playerid;
 	pcard->current.location = location;
 	switch (location) {
@@ -1172,11 +1175,15 @@ void field::shuffle(uint8_t playerid, uint8_t location) {
 		if(location == LOCATION_EXTRA)
 			upper_bound -= player[playerid].extra_p_count;
 		if(upper_bound > 1) {
-			for(int32_t i = 0; i < upper_bound - 1; ++i) {
-				auto r = pduel->get_next_integer(i, upper_bound - 1);
-				auto* t = to_shuffle[i];
-				to_shuffle[i] = to_shuffle[r];
-				to_shuffle[r] = t;
+			if(pduel->fast_rng) {
+				pduel->shuffle(to_shuffle.begin(), upper_bound);
+			} else {
+				for(int32_t i = 0; i < upper_bound - 1; ++i) {
+					auto r = pduel->get_next_integer(i, upper_bound - 1);
+					auto* t = to_shuffle[i];
+					to_shuffle[i] = to_shuffle[r];
+					to_shuffle[r] = t;
+				}
 			}
 			reset_sequence(playerid, location);
 		}
@@ -1208,13 +1215,12 @@ void field::shuffle(uint8_t playerid, uint8_t location) {
 			}
 		}
 	} else {
-		auto message = pduel->new_message(MSG_SHUFFLE_DECK);
-		message->write<uint8_t>(playerid);
+		pduel->write_message<MSG_SHUFFLE_DECK>(playerid);
 		core.shuffle_deck_check[playerid] = false;
 		if(core.global_flag & GLOBALFLAG_DECK_REVERSE_CHECK) {
 			card* ptop = to_shuffle.back();
 			if(core.deck_reversed || (ptop->current.position == POS_FACEUP_DEFENSE)) {
-				message = pduel->new_message(MSG_DECK_TOP);
+				auto message = pduel->new_message(MSG_DECK_TOP);
 				message->write<uint8_t>(playerid);
 				message->write<uint32_t>(0);
 				message->write<uint32_t>(ptop->data.code);
@@ -1461,9 +1467,7 @@ void field::next_player(uint8_t playerid) {
 		message->write<uint32_t>(pcard->current.position);
 	}
 	player[playerid].lp = player[playerid].start_lp;
-	message = pduel->new_message(MSG_LPUPDATE);
-	message->write<uint8_t>(playerid);
-	message->write<uint32_t>(player[playerid].start_lp);
+	pduel->write_message<MSG_LPUPDATE>(playerid, player[playerid].start_lp);
 	player[playerid].recharge = false;
 }
 bool field::is_flag(uint64_t flag) const {
@@ -1506,6 +1510,7 @@ void field::add_effect(effect* peffect, uint8_t owner_player) {
 	effect_container::iterator it;
 	if (!(peffect->type & EFFECT_TYPE_ACTIONS)) {
 		it = effects.aura_effect.emplace(peffect->code, peffect);
+		count_adjust_effect(peffect->code, 1);
 		if(peffect->code == EFFECT_SELF_TOGRAVE)
 			core.global_flag |= GLOBALFLAG_SELF_TOGRAVE;
 		else if(peffect->code == EFFECT_SPSUMMON_COUNT_LIMIT)
@@ -1573,6 +1578,7 @@ void field::remove_effect(effect* peffect) {
 		return;
 	auto it = eit->second;
 	if (!(peffect->type & EFFECT_TYPE_ACTIONS)) {
+		count_adjust_effect(it->first, -1);
 		effects.aura_effect.erase(it);
 		if(peffect->code == EFFECT_SPSUMMON_COUNT_LIMIT)
 			effects.spsummon_count_eff.erase(peffect);
@@ -1680,6 +1686,14 @@ processor::effect_count_map& field::get_count_map(uint8_t flag) {
 static inline uint64_t generate_count_map_key(uint32_t code, uint8_t flag, uint8_t hopt_index, uint8_t playerid) {
 	return static_cast<uint64_t>(code) << 32 | (hopt_index << 16 | flag << 8 | playerid);
 }
+void field::count_adjust_effect(uint32_t code, int32_t delta) {
+	if(code == EFFECT_DISABLE_TRAPMONSTER)
+		effects.disable_trapmonster_count += delta;
+	else if(code == EFFECT_SET_POSITION)
+		effects.set_position_count += delta;
+	else if(code == EFFECT_ADD_TYPE || code == EFFECT_CHANGE_TYPE)
+		effects.add_type_count += delta;
+}
 void field::add_effect_code(uint32_t code, uint8_t flag, uint8_t hopt_index, uint8_t playerid) {
 	auto& count_map = get_count_map(flag);
 	const auto key = generate_count_map_key(code, hopt_index, flag, playerid);
@@ -1824,6 +1838,17 @@ void field::filter_inrange_cards(effect* peffect, card_set* cset) {
 		}
 	}
 }
+// With DUEL_LAZY_CARD_INIT the cards starting in the deck run their initial_effect only when needed,
+// this has to be called before the cards in playerid's deck are exposed to the scripts
+void field::init_deck_cards(uint8_t playerid) {
+	if(!is_flag(DUEL_LAZY_CARD_INIT))
+		return;
+	const auto& list_main = player[playerid].list_main;
+	for(size_t i = 0; i < list_main.size(); ++i) {
+		if(list_main[i]->pending_initial_effect)
+			pduel->lua->run_initial_effect(list_main[i]);
+	}
+}
 void field::filter_player_effect(uint8_t playerid, uint32_t code, effect_set* eset, bool sort) {
 	auto rg = effects.aura_effect.equal_range(code);
 	for (; rg.first != rg.second; ++rg.first) {
@@ -1837,14 +1862,24 @@ void field::filter_player_effect(uint8_t playerid, uint32_t code, effect_set* es
 int32_t field::filter_matching_card(int32_t findex, uint8_t self, uint32_t location1, uint32_t location2, group* pgroup, card* pexception, group* pexgroup, uint32_t extraargs, card** pret, int32_t fcount, bool is_target) {
 	if(self != 0 && self != 1)
 		return FALSE;
+	if(location1 & LOCATION_DECK)
+		init_deck_cards(self);
+	if(location2 & LOCATION_DECK)
+		init_deck_cards(1 - self);
 	int32_t count = 0;
-	auto checkc = [&](auto* pcard, bool(*extrafil)(card* pcard)=nullptr)->bool {
-		if(pcard && (!extrafil || extrafil(pcard))
-		   && pcard != pexception && !(pexgroup && pexgroup->has_card(pcard))
+	auto prefilter = [&](card* pcard)->bool {
+		if(pcard == pexception || (pexgroup && pexgroup->has_card(pcard)))
+			return false;
+		////kdiy////////////
+		if(pcard->is_affected_by_effect(EFFECT_ASSUME_ZERO))
+			return false;
+		////kdiy////////////
+		return true;
+	};
+	auto accept = [&](card* pcard, bool matched)->bool {
+		if(matched
 		   ////kdiy////////////
-		   && !pcard->is_affected_by_effect(EFFECT_ASSUME_ZERO)
-		   //&& (!findex || pduel->lua->check_matching(pcard, findex, extraargs))
-		   && (!findex || (pduel->lua->check_matching(pcard, findex, extraargs) && !pcard->is_affected_by_effect(EFFECT_DARKNESS_HIDE)))
+		   && (!findex || !pcard->is_affected_by_effect(EFFECT_DARKNESS_HIDE))
 		   ////kdiy////////////
 		   && (!is_target || pcard->is_capable_be_effect_target(core.reason_effect, core.reason_player))) {
 			if(pret) {
@@ -1859,6 +1894,24 @@ int32_t field::filter_matching_card(int32_t findex, uint8_t self, uint32_t locat
 		}
 		return false;
 	};
+	auto checkc = [&](auto* pcard, bool(*extrafil)(card* pcard)=nullptr)->bool {
+		if(pcard && (!extrafil || extrafil(pcard)) && prefilter(pcard))
+			return accept(pcard, !findex || pduel->lua->check_matching(pcard, findex, extraargs));
+		return false;
+	};
+	// when every matching card is collected (no early exit), the filter is evaluated
+	// for the whole pile with a single batched lua call
+	auto check_pile = [&](const card_vector& list)->bool {
+		if(pret || fcount || !findex || list.size() < interpreter::matching_batch_threshold)
+			return std::find_if(list.begin(), list.end(), checkc) != list.end();
+		card_vector candidates;
+		for(auto& pcard : list) {
+			if(pcard && prefilter(pcard))
+				candidates.push_back(pcard);
+		}
+		pduel->lua->check_matching_each(candidates, findex, extraargs, accept);
+		return false;
+	};
 	////kdiy////////////
 	auto rmzonechk = [&checkc](auto pcard)->bool {
 		return checkc(pcard, [](auto pcard)->bool {return !pcard->get_status(STATUS_SUMMONING | STATUS_SUMMON_DISABLED | STATUS_SPSUMMON_STEP); });
@@ -1959,15 +2012,15 @@ int32_t field::filter_matching_card(int32_t findex, uint8_t self, uint32_t locat
 			if((location & LOCATION_PZONE) && (pzonechk(player[self].list_szone[get_pzone_index(0, self)]) || pzonechk(player[self].list_szone[get_pzone_index(1, self)])))
 				return TRUE;
 		}
-		if((location & LOCATION_DECK) && check_list(player[self].list_main, checkc))
+		if((location & LOCATION_DECK) && check_pile(player[self].list_main))
 			return TRUE;
-		if((location & LOCATION_EXTRA) && check_list(player[self].list_extra, checkc))
+		if((location & LOCATION_EXTRA) && check_pile(player[self].list_extra))
 			return TRUE;
-		if((location & LOCATION_HAND) && check_list(player[self].list_hand, checkc))
+		if((location & LOCATION_HAND) && check_pile(player[self].list_hand))
 			return TRUE;
-		if((location & LOCATION_GRAVE) && check_list(player[self].list_grave, checkc))
+		if((location & LOCATION_GRAVE) && check_pile(player[self].list_grave))
 			return TRUE;
-		if((location & LOCATION_REMOVED) && check_list(player[self].list_remove, checkc))
+		if((location & LOCATION_REMOVED) && check_pile(player[self].list_remove))
 			return TRUE;
 	}
 	return FALSE;
@@ -1976,6 +2029,10 @@ int32_t field::filter_matching_card(int32_t findex, uint8_t self, uint32_t locat
 int32_t field::filter_field_card(uint8_t self, uint32_t location1, uint32_t location2, group* pgroup) {
 	if(self != 0 && self != 1)
 		return 0;
+	if(pgroup && (location1 & LOCATION_DECK))
+		init_deck_cards(self);
+	if(pgroup && (location2 & LOCATION_DECK))
+		init_deck_cards(1 - self);
 	uint32_t location = location1;
 	size_t count = 0;
 	for(uint32_t p = 0; p < 2; ++p, location = location2, self = 1 - self) {
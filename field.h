@@ -7,6 +7,7 @@
 #ifndef FIELD_H_
 #define FIELD_H_
 
+#include <algorithm> //std::find_if
 #include <array>
 #include <list>
 #include <map>
@@ -47,7 +48,27 @@ struct optarget {
 	int32_t op_param;
 };
 struct chain {
-	using opmap = std::unordered_map<uint32_t, optarget>;
+	// operation infos indexed by category, a chain rarely has more than a couple of them
+	// so a flat vector is cheaper to create, copy and search than a hash map
+	class opmap {
+		using container = std::vector<std::pair<uint32_t, optarget>>;
+		container entries;
+	public:
+		using iterator = container::iterator;
+		iterator begin() { return entries.begin(); }
+		iterator end() { return entries.end(); }
+		iterator find(uint32_t category) {
+			return std::find_if(entries.begin(), entries.end(), [category](const auto& entry) { return entry.first == category; });
+		}
+		size_t count(uint32_t category) { return find(category) != end() ? 1 : 0; }
+		optarget& operator[](uint32_t category) {
+			if(auto it = find(category); it != end())
+				return it->second;
+			return entries.emplace_back(category, optarget{}).second;
+		}
+		size_t size() const { return entries.size(); }
+		void clear() { entries.clear(); }
+	};
 	using applied_chain_counter_t = std::vector<uint32_t>;
 	card_state triggering_state;
 	tevent evt;
@@ -158,6 +179,14 @@ struct field_effect {
 	card_set disable_check_set;
 
 	grant_effect_container grant_effect;
+
+	// registered effects that can affect a card with the codes checked by some adjust steps,
+	// when there are none the step can't change anything and is skipped
+	uint32_t disable_trapmonster_count{};
+	uint32_t set_position_count{};
+	// same for the effects that can turn a card into a link monster,
+	// when there are none only cards printed as link can have linked zones
+	uint32_t add_type_count{};
 };
 struct field_info {
 	uint32_t event_id{ 1 };
@@ -369,6 +398,12 @@ struct processor {
 	uint8_t current_player;
 	uint8_t conti_player{ PLAYER_NONE };
 	bool force_turn_end;
+	uint64_t adjust_passes{};
+	uint64_t adjust_trap_monster_skipped{};
+	uint64_t adjust_position_skipped{};
+	uint64_t event_condition_checks_skipped{};
+	uint64_t events_raised{};
+	uint64_t event_groups_created{};
 	action_counter_t summon_counter;
 	action_counter_t normalsummon_counter;
 	action_counter_t spsummon_counter;
@@ -429,6 +464,7 @@ public:
 	void swap_card(card* pcard1, card* pcard2);
 	void set_control(card* pcard, uint8_t playerid, uint16_t reset_phase, uint8_t reset_count);
 	card* get_field_card(uint32_t playerid, uint32_t location, uint32_t sequence);
+	void init_deck_cards(uint8_t playerid);
 	int32_t is_location_useable(uint32_t playerid, uint32_t location, uint32_t sequence);
 	int32_t get_useable_count(card* pcard, uint8_t playerid, uint8_t location, uint8_t uplayer, uint32_t reason, uint32_t zone = 0xff, uint32_t* list = nullptr);
 	int32_t get_useable_count_fromex(card* pcard, uint8_t playerid, uint8_t uplayer, uint32_t zone = 0xff, uint32_t* list = nullptr);
@@ -463,6 +499,7 @@ public:
 
 	void add_effect(effect* peffect, uint8_t owner_player = 2);
 	void remove_effect(effect* peffect);
+	void count_adjust_effect(uint32_t code, int32_t delta);
 	void remove_oath_effect(effect* reason_effect);
 	void release_oath_relation(effect* reason_effect);
 	void reset_phase(uint32_t phase);
@@ -571,7 +608,9 @@ public:
 
 	void raise_event(card* event_card, uint32_t event_code, effect* reason_effect, uint32_t reason, uint8_t reason_player, uint8_t event_player, uint32_t event_value);
 	void raise_event(card_set event_cards, uint32_t event_code, effect* reason_effect, uint32_t reason, uint8_t reason_player, uint8_t event_player, uint32_t event_value);
+	void raise_event(const owned_lua<group>& event_cards, uint32_t event_code, effect* reason_effect, uint32_t reason, uint8_t reason_player, uint8_t event_player, uint32_t event_value);
 	void raise_single_event(card* trigger_card, card_set* event_cards, uint32_t event_code, effect* reason_effect, uint32_t reason, uint8_t reason_player, uint8_t event_player, uint32_t event_value);
+	void raise_single_event(card* trigger_card, const owned_lua<group>& event_cards, uint32_t event_code, effect* reason_effect, uint32_t reason, uint8_t reason_player, uint8_t event_player, uint32_t event_value);
 	int32_t check_event(uint32_t code, tevent* pe = nullptr);
 	int32_t check_event_c(effect* peffect, uint8_t playerid, int32_t neglect_con, int32_t neglect_cost, int32_t copy_info, tevent* pe = nullptr);
 	int32_t check_hint_timing(effect* peffect);
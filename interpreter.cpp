@@ -4,7 +4,10 @@
  *
  * SPDX-License-Identifier: AGPL-3.0-or-later
  */
+#include <chrono>
 #include <cstring> //std::memcpy
+#include <string>
+#include <tuple> //std::tie
 #include <utility> //std::exchange
 #include <vector>
 #include "duel.h"
@@ -19,6 +22,7 @@
 using namespace scriptlib;
 
 // This function will be used by a lua library built with api check
+// it only accesses the duel bound to the state, so it can be called concurrently by different duels
 #ifdef __GNUC__
 [[gnu::used]]
 #endif
@@ -57,8 +61,53 @@ static bool check_lua_stack_unwinding(lua_State* L) {
 	return flag == 0xFFFFFFFF;
 }
 
-interpreter::interpreter(duel* pd, const OCG_DuelOptions& options, bool& valid_lua_lib): coroutines(256), deleted(pd) {
-	lua_state = luaL_newstate();
+// The limit is only enforced while a script is being loaded or is running, as there the allocation failure
+// is raised as an error that will be caught, outside of a protected call it would abort the whole program instead.
+// A refused allocation isn't a failure yet, as lua will run an emergency collection and retry it,
+// the duel is only flagged (and ended as soon as control returns to OCG_DuelProcess) when a
+// protected call or a load actually fails with LUA_ERRMEM, see interpreter::check_memory_error
+static void* lua_alloc(void* ud, void* ptr, size_t osize, size_t nsize) {
+	auto* lua = static_cast<interpreter*>(ud);
+	auto& allocator = lua->allocator;
+	if(ptr == nullptr)
+		osize = 0;
+	if(nsize > osize && (lua->call_depth > 0 || lua->no_action > 0) && allocator.would_exceed_limit(nsize - osize))
+		return nullptr;
+	return allocator.reallocate(ptr, osize, nsize);
+}
+
+// Called every 1000 instructions when the duel has an instruction budget, the running
+// script can't be suspended from here, the budget is checked between processor steps
+static constexpr int instruction_hook_count = 1000;
+static void lua_count_hook(lua_State* L, lua_Debug* /*ar*/) {
+	auto pduel = lua_get<duel*>(L);
+	++pduel->lua->instruction_ticks;
+}
+
+static int lua_panic(lua_State* L) {
+	auto pduel = lua_get<duel*>(L);
+	const char* msg = lua_tostring(L, -1);
+	pduel->handle_message(msg ? msg : "unprotected error in call to Lua API", OCG_LOG_TYPE_ERROR);
+	return 0;
+}
+
+/*
+	Loop used to evaluate a filter over many cards with a single call from the core,
+	every result is stored as a boolean so that, if a call errors, the first
+	nil entry corresponds to the card that raised the error.
+*/
+static constexpr char matching_batch_driver_source[] = R"(
+return function(results, cards, first, last, f, ...)
+	for i = first, last do
+		results[i] = f(cards[i], ...) and true or false
+	end
+end
+)";
+
+interpreter::interpreter(duel* pd, const OCG_DuelOptions& options, bool& valid_lua_lib): coroutines(256), deleted(pd), allocator(options.luaMemoryLimit), gc_step_budget(options.gc.stepBudget), instruction_budget(options.budget.luaInstructions) {
+	call_depth = 0;
+	lua_state = lua_newstate(lua_alloc, this);
+	lua_atpanic(lua_state, lua_panic);
 	if(!check_lua_stack_unwinding(lua_state)) {
 		valid_lua_lib = false;
 		pd->handle_message("The lua library linked with this ocgcore does not support c++'s stack unwinding", OCG_LOG_TYPE_ERROR);
@@ -66,8 +115,8 @@ interpreter::interpreter(duel* pd, const OCG_DuelOptions& options, bool& valid_l
 	}
 	current_state = lua_state;
 	pduel = pd;
+	params.reserve(16);
 	no_action = 0;
-	call_depth = 0;
 	std::memcpy(lua_getextraspace(lua_state), &pd, sizeof(duel*));
 	// Open basic and used functionality
 	auto open_lib = [L=lua_state](const char* libname, lua_CFunction openf) {
@@ -107,6 +156,29 @@ interpreter::interpreter(duel* pd, const OCG_DuelOptions& options, bool& valid_l
 		lua_setmetatable(lua_state, -2);
 		weak_lua_references = ensure_luaL_stack(luaL_ref, lua_state, LUA_REGISTRYINDEX);
 	}
+	{
+		luaL_checkstack(lua_state, 1, nullptr);
+		ensure_luaL_stack(luaL_loadbuffer, lua_state, matching_batch_driver_source, sizeof(matching_batch_driver_source) - 1, "=matching_batch_driver");
+		lua_call(lua_state, 0, 1);
+		matching_batch_driver = ensure_luaL_stack(luaL_ref, lua_state, LUA_REGISTRYINDEX);
+	}
+	{
+		const auto& gc = options.gc;
+#if LUA_VERSION_NUM <= 503
+		if(gc.pause != 0)
+			lua_gc(lua_state, LUA_GCSETPAUSE, gc.pause);
+		if(gc.stepMultiplier != 0)
+			lua_gc(lua_state, LUA_GCSETSTEPMUL, gc.stepMultiplier);
+#else
+		if(gc.mode == OCG_GC_MODE_GENERATIONAL)
+			lua_gc(lua_state, LUA_GCGEN, gc.minorMultiplier, gc.majorMultiplier);
+		else
+			lua_gc(lua_state, LUA_GCINC, gc.pause, gc.stepMultiplier, gc.stepSize);
+#endif
+	}
+	// threads created afterwards (the coroutines) inherit the hook
+	if(instruction_budget != 0)
+		lua_sethook(lua_state, lua_count_hook, LUA_MASKCOUNT, instruction_hook_count);
 	// Open all card scripting libs
 	scriptlib::push_card_lib(lua_state);
 	scriptlib::push_effect_lib(lua_state);
@@ -127,7 +199,7 @@ static inline lua_obj** create_object(lua_State* L) {
 	return static_cast<lua_obj**>(lua_newuserdatauv(L, sizeof(lua_obj*), 0));
 #endif
 }
-void interpreter::register_card(card* pcard) {
+void interpreter::register_card(card* pcard, bool lazy_init) {
 	//create a card in by userdata
 	luaL_checkstack(lua_state, 1, nullptr);
 	luaL_checkstack(current_state, 1, nullptr);
@@ -142,19 +214,47 @@ void interpreter::register_card(card* pcard) {
 		load_card_script(pcard->data.alias);
 	else
 		load_card_script(pcard->data.code);
+	if(lazy_init) {
+		//only the scripts declaring that their initial_effect only affects the card itself,
+		//and does nothing while it's in the deck, can be deferred
+		luaL_checkstack(current_state, 1, nullptr);
+		lua_getfield(current_state, -1, "lazy_initial_effect");
+		lazy_init = pcard->data.code && lua_toboolean(current_state, -1);
+		lua_pop(current_state, 1);
+	}
 	//set metatable of pointer to base script
 	lua_setmetatable(current_state, -2);
 	lua_pop(current_state, 1);
-	//Initial
-	if(pcard->data.code) {
-		const bool forced = !(pcard->data.type & TYPE_NORMAL) || (pcard->data.type & TYPE_PENDULUM);
-		pcard->set_status(STATUS_INITIALIZING, TRUE);
-		add_param<LuaParam::CARD>(pcard);
-		call_card_function(pcard, "initial_effect", 1, 0, forced);
-		pcard->set_status(STATUS_INITIALIZING, FALSE);
+	if(lazy_init) {
+		//the ids the effects would have taken are reserved, so that they keep the same order
+		//relative to the ones of the objects created afterwards
+		auto& field_id = pduel->game_field->infos.field_id;
+		pcard->pending_initial_effect = true;
+		pcard->lazy_field_id = field_id;
+		field_id += lazy_field_id_reserve;
+	} else {
+		run_initial_effect(pcard);
 	}
 	pcard->cardid = pduel->game_field->infos.card_id++;
 }
+//Initial
+void interpreter::run_initial_effect(card* pcard) {
+	const auto lazy = std::exchange(pcard->pending_initial_effect, false);
+	if(!pcard->data.code)
+		return;
+	auto& field_id = pduel->game_field->infos.field_id;
+	const auto next_field_id = lazy ? std::exchange(field_id, pcard->lazy_field_id) : 0;
+	const bool forced = !(pcard->data.type & TYPE_NORMAL) || (pcard->data.type & TYPE_PENDULUM);
+	pcard->set_status(STATUS_INITIALIZING, TRUE);
+	add_param<LuaParam::CARD>(pcard);
+	call_card_function(pcard, "initial_effect", 1, 0, forced);
+	pcard->set_status(STATUS_INITIALIZING, FALSE);
+	if(!lazy)
+		return;
+	if(field_id - pcard->lazy_field_id > lazy_field_id_reserve)
+		pduel->handle_message("a lazily initialized card used more field ids than the ones reserved for it, the order of its effects may differ", OCG_LOG_TYPE_ERROR);
+	field_id = next_field_id;
+}
 static inline void remove_object(lua_State* L, lua_obj* obj, lua_obj* replacement) {
 	if(!obj || !obj->ref_handle)
 		return;
@@ -173,17 +273,17 @@ void interpreter::unregister_effect(effect* peffect) {
 	if (!peffect)
 		return;
 	if(peffect->condition)
-		ensure_luaL_stack(luaL_unref, lua_state, LUA_REGISTRYINDEX, peffect->condition);
+		release_lua_ref(peffect->condition);
 	if(peffect->cost)
-		ensure_luaL_stack(luaL_unref, lua_state, LUA_REGISTRYINDEX, peffect->cost);
+		release_lua_ref(peffect->cost);
 	if(peffect->target)
-		ensure_luaL_stack(luaL_unref, lua_state, LUA_REGISTRYINDEX, peffect->target);
+		release_lua_ref(peffect->target);
 	if(peffect->operation)
-		ensure_luaL_stack(luaL_unref, lua_state, LUA_REGISTRYINDEX, peffect->operation);
+		release_lua_ref(peffect->operation);
 	if(peffect->value && peffect->is_flag(EFFECT_FLAG_FUNC_VALUE))
-		ensure_luaL_stack(luaL_unref, lua_state, LUA_REGISTRYINDEX, peffect->value);
+		release_lua_ref(peffect->value);
 	if(peffect->label_object)
-		ensure_luaL_stack(luaL_unref, lua_state, LUA_REGISTRYINDEX, peffect->label_object);
+		release_lua_ref(peffect->label_object);
 	remove_object(lua_state, peffect, &deleted);
 }
 void interpreter::register_group(group* pgroup) {
@@ -210,15 +310,50 @@ void interpreter::register_obj(lua_obj* obj, const char* tablename, bool weak) {
 		obj->ref_handle = ensure_luaL_stack(luaL_ref, lua_state, LUA_REGISTRYINDEX);
 	}
 }
-void interpreter::collect(bool full) {
-	lua_gc(current_state, full ? LUA_GCCOLLECT : LUA_GCSTEP, 0);
+/*
+	Called from the __gc metamethod of a group, the weak table already dropped its userdata,
+	so the slot is put back in the table's free list to be reused by the next groups
+	instead of growing the table for every temporary group.
+	The userdata itself is not reused, resurrecting it would keep it as a key of the
+	weak keyed tables of the scripts, that would then see the new group in place of the old one.
+*/
+void interpreter::unregister_group(group* pgroup) {
+	if(!pgroup || pgroup->weak_ref_handle == 0)
+		return;
+	luaL_checkstack(lua_state, 1, nullptr);
+	lua_rawgeti(lua_state, LUA_REGISTRYINDEX, weak_lua_references);
+	luaL_unref(lua_state, -1, pgroup->weak_ref_handle);
+	lua_pop(lua_state, 1);
+	pgroup->weak_ref_handle = 0;
+}
+// returns true if the step finished a collection cycle
+bool interpreter::collect(bool full) {
+	const auto start = std::chrono::steady_clock::now();
+	const bool cycle_finished = lua_gc(current_state, full ? LUA_GCCOLLECT : LUA_GCSTEP, 0) != 0;
+	gc_time += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	++gc_collections;
+	return cycle_finished;
+}
+// performs the collection work allowed by the duel options, to be called when the
+// core is about to return control to the host, so that the time isn't spent mid chain
+void interpreter::collect_step_budget() {
+	for(uint32_t i = 0; i < gc_step_budget; ++i) {
+		if(collect())
+			break;
+	}
 }
 bool interpreter::load_script(const char* buffer, int len, const char* script_name) {
 	if(!buffer)
 		return false;
 	++no_action;
-	if(ensure_luaL_stack(luaL_loadbuffer, current_state, buffer, len, script_name) != LUA_OK
-	   || lua_pcall(current_state, 0, 0, 0) != LUA_OK) {
+	const auto loaded = check_memory_error(ensure_luaL_stack(luaL_loadbuffer, current_state, buffer, len, script_name)) == LUA_OK;
+	if(pduel->script_cache_target && ++pduel->script_cache_loads == 1 && loaded) {
+		lua_dump(current_state, [](lua_State* /*L*/, const void* p, size_t sz, void* ud) {
+			static_cast<std::string*>(ud)->append(static_cast<const char*>(p), sz);
+			return 0;
+		}, pduel->script_cache_target, 0);
+	}
+	if(!loaded || check_memory_error(lua_pcall(current_state, 0, 0, 0)) != LUA_OK) {
 		pduel->handle_message(lua_get_string_or_empty(current_state, -1), OCG_LOG_TYPE_ERROR);
 		lua_pop(current_state, 1);
 		--no_action;
@@ -293,7 +428,7 @@ bool interpreter::load_card_script(uint32_t code) {
 	}
 	return res;
 }
-void interpreter::push_param(lua_State* L, bool is_coroutine) {
+void interpreter::push_param(lua_State* L, bool is_coroutine, int32_t pushed_before) {
 	int32_t pushed = 0;
 	luaL_checkstack(L, static_cast<uint32_t>(params.size()), nullptr);
 	for(const auto& [param, type] : params) {
@@ -324,8 +459,9 @@ void interpreter::push_param(lua_State* L, bool is_coroutine) {
 				lua_pushvalue(current_state, index);
 				lua_xmove(current_state, L, 1);
 			} else {
-				//the calling function is pushed before the params, so the actual index is: index - pushed -1
-				lua_pushvalue(L, index - pushed - 1);
+				//the calling function (and possibly the error handler) is pushed before the params,
+				//so the actual index is: index - pushed - pushed_before
+				lua_pushvalue(L, index - pushed - pushed_before);
 			}
 			break;
 		}
@@ -336,21 +472,38 @@ void interpreter::push_param(lua_State* L, bool is_coroutine) {
 	}
 	params.clear();
 }
-inline int interpreter::call_lua(lua_State* L, int nargs, int nresults) {
-	++no_action;
-	++call_depth;
-	/*
-		Push the error handler function, when called, it will have a single
-		argument passed to it, consisting of the error object, since we do
-		nothing with it, return it directly.
-		It's actually faster and simpler to push the light C function each
-		time than to store it in the global registry and retrieve it every call.
-	*/
-	luaL_checkstack(L, 1, nullptr);
+/*
+	Push the error handler function, when called, it will have a single
+	argument passed to it, consisting of the error object, since we do
+	nothing with it, return it directly.
+	It's actually faster and simpler to push the light C function each
+	time than to store it in the global registry and retrieve it every call.
+	Returns the absolute index of the handler.
+*/
+int interpreter::push_error_handler(lua_State* L) {
 	lua_pushcfunction(L, [](lua_State* L) -> int32_t {
 		interpreter::print_stacktrace(L);
 		return 1;
 	});
+	return lua_gettop(L);
+}
+// Calls the function below the nargs on top of the stack, with the error handler
+// already pushed by the caller at error_handler_index, which also has to remove it afterwards.
+// This is the fast path used by the most frequent calls, as it avoids rotating the stack.
+inline int interpreter::call_lua(lua_State* L, int nargs, int nresults, int error_handler_index) {
+	++no_action;
+	++call_depth;
+	auto ret = check_memory_error(lua_pcall(L, nargs, nresults, error_handler_index));
+	--no_action;
+	--call_depth;
+	if(call_depth == 0) {
+		pduel->restore_assumes();
+	}
+	return ret;
+}
+inline int interpreter::call_lua(lua_State* L, int nargs, int nresults) {
+	luaL_checkstack(L, 1, nullptr);
+	push_error_handler(L);
 	/*
 		The stack contains nargs on top, and the function below them.
 		We put the error handler below the function object, save its new
@@ -358,14 +511,9 @@ inline int interpreter::call_lua(lua_State* L, int nargs, int nresults) {
 	*/
 	lua_insert(L, -(nargs + 2));
 	auto error_handler_index = lua_absindex(L, -(nargs + 2));
-	auto ret = lua_pcall(L, nargs, nresults, error_handler_index);
+	auto ret = call_lua(L, nargs, nresults, error_handler_index);
 	// We need to remove the error handler from the stack to clean things up.
 	lua_remove(L, error_handler_index);
-	--no_action;
-	--call_depth;
-	if(call_depth == 0) {
-		pduel->restore_assumes();
-	}
 	return ret;
 }
 inline bool interpreter::ret_fail(const char* message) {
@@ -403,6 +551,30 @@ bool interpreter::call_function(int32_t function, uint32_t param_count, int32_t
 		return ret_fail(R"("CallFunction": attempt to call an error function)");
 	return call_function(param_count, ret_count);
 }
+// Same as call_function with a single return value, but the error handler is pushed
+// before the function so that no stack rotation is needed.
+// On success the result is left on top of the stack with the error handler below it,
+// and the caller is responsible of popping both.
+bool interpreter::call_function_single_result(int32_t function, uint32_t param_count) {
+	if (!function)
+		return ret_fail(R"("CallFunction": attempt to call a null function.)");
+	if (param_count != params.size())
+		return ret_fail(format(R"("CallFunction": incorrect parameter count (%u expected, %zu pushed))", param_count, params.size()));
+	luaL_checkstack(current_state, static_cast<int>(param_count) + 2, nullptr);
+	const auto error_handler = push_error_handler(current_state);
+	pushobject(current_state, function);
+	if (!lua_isfunction(current_state, -1)) {
+		lua_pop(current_state, 2);
+		return ret_fail(R"("CallFunction": attempt to call an error function)");
+	}
+	push_param(current_state, false, 2);
+	if(call_lua(current_state, param_count, 1, error_handler) != LUA_OK) {
+		pduel->handle_message(lua_get_string_or_empty(current_state, -1), OCG_LOG_TYPE_ERROR);
+		lua_pop(current_state, 2);
+		return false;
+	}
+	return true;
+}
 bool interpreter::call_card_function(card* pcard, const char* function_name, uint32_t param_count, int32_t ret_count, bool forced) {
 	if (param_count != params.size())
 		return ret_fail(format(R"("CallCardFunction"(c%u.%s): incorrect parameter count)", pcard->data.code, function_name));
@@ -433,10 +605,10 @@ bool interpreter::check_condition(int32_t function, uint32_t param_count) {
 		params.clear();
 		return true;
 	}
-	if(!call_function(function, param_count, 1))
+	if(!call_function_single_result(function, param_count))
 		return false;
 	bool result = lua_toboolean(current_state, -1);
-	lua_pop(current_state, 1);
+	lua_pop(current_state, 2);
 	return result;
 }
 static inline void push_range_of_values(lua_State* L, int32_t idx, int32_t amount) {
@@ -444,47 +616,109 @@ static inline void push_range_of_values(lua_State* L, int32_t idx, int32_t amoun
 	for(int i = 0; i < amount; ++i)
 		lua_pushvalue(L, idx + i);
 }
+/*
+	Pushes the error handler, the function at findex, the card and the extraargs values
+	currently on top of the stack, in this order, ready to be passed to call_lua.
+	The stack space for all of them is checked at once.
+	Returns the index of the error handler.
+*/
+static inline int push_matching_call(lua_State* L, card* pcard, int32_t findex, int32_t extraargs) {
+	luaL_checkstack(L, extraargs + 3, nullptr);
+	findex = lua_absindex(L, findex);
+	const auto first_extra_arg = lua_gettop(L) - extraargs + 1;
+	const auto error_handler = interpreter::push_error_handler(L);
+	lua_pushvalue(L, findex);
+	interpreter::pushobject(L, pcard);
+	for(int i = 0; i < extraargs; ++i)
+		lua_pushvalue(L, first_extra_arg + i);
+	return error_handler;
+}
 bool interpreter::check_matching(card* pcard, int32_t findex, int32_t extraargs) {
-	luaL_checkstack(current_state, extraargs + 2, nullptr);
-	lua_pushvalue(current_state, findex);
-	pushobject(current_state, pcard);
-	push_range_of_values(current_state, -(extraargs + 2), extraargs);
+	const auto error_handler = push_matching_call(current_state, pcard, findex, extraargs);
 	auto result = false;
-	if(call_lua(current_state, 1 + extraargs, 1) != LUA_OK) {
+	if(call_lua(current_state, 1 + extraargs, 1, error_handler) != LUA_OK) {
 		pduel->handle_message(lua_get_string_or_empty(current_state, -1), OCG_LOG_TYPE_ERROR);
 	} else
 		result = lua_toboolean(current_state, -1);
-	lua_pop(current_state, 1);
+	lua_pop(current_state, 2);
 	return result;
 }
+void interpreter::check_matching(const card_vector& cards, int32_t findex, int32_t extraargs, std::vector<bool>& result) {
+	result.assign(cards.size(), false);
+	if(cards.empty())
+		return;
+	auto* L = current_state;
+	luaL_checkstack(L, extraargs + 9, nullptr);
+	findex = lua_absindex(L, findex);
+	const auto first_extra_arg = lua_gettop(L) - extraargs + 1;
+	const auto count = static_cast<lua_Integer>(cards.size());
+	lua_createtable(L, static_cast<int>(count), 0);
+	const auto cards_table = lua_gettop(L);
+	lua_Integer i = 0;
+	for(auto* pcard : cards) {
+		pushobject(L, pcard);
+		lua_rawseti(L, cards_table, ++i);
+	}
+	lua_createtable(L, static_cast<int>(count), 0);
+	const auto results_table = lua_gettop(L);
+	for(lua_Integer first = 1; first <= count;) {
+		const auto error_handler = push_error_handler(L);
+		lua_rawgeti(L, LUA_REGISTRYINDEX, matching_batch_driver);
+		lua_pushvalue(L, results_table);
+		lua_pushvalue(L, cards_table);
+		lua_pushinteger(L, first);
+		lua_pushinteger(L, count);
+		lua_pushvalue(L, findex);
+		for(int32_t arg = 0; arg < extraargs; ++arg)
+			lua_pushvalue(L, first_extra_arg + arg);
+		if(call_lua(L, 5 + extraargs, 0, error_handler) == LUA_OK) {
+			lua_pop(L, 1);
+			break;
+		}
+		// same as check_matching, a card whose filter raised an error doesn't match,
+		// log it and resume from the card after it
+		pduel->handle_message(lua_get_string_or_empty(L, -1), OCG_LOG_TYPE_ERROR);
+		lua_pop(L, 2);
+		while(first <= count) {
+			const bool evaluated = lua_rawgeti(L, results_table, first) != LUA_TNIL;
+			lua_pop(L, 1);
+			if(!evaluated)
+				break;
+			++first;
+		}
+		++first;
+	}
+	for(i = 1; i <= count; ++i) {
+		lua_rawgeti(L, results_table, i);
+		result[i - 1] = lua_toboolean(L, -1);
+		lua_pop(L, 1);
+	}
+	lua_pop(L, 2);
+}
 bool interpreter::check_matching_table(card* pcard, int32_t findex, int32_t table_index) {
 	if(!findex || !lua_istable(current_state, table_index))
 		return true;
-	luaL_checkstack(current_state, 2, nullptr);
-	lua_pushvalue(current_state, findex);
-	pushobject(current_state, pcard);
+	table_index = lua_absindex(current_state, table_index);
+	const auto error_handler = push_matching_call(current_state, pcard, findex, 0);
 	int extraargs = pushExpandedTable(current_state, table_index);
 	auto result = false;
-	if(call_lua(current_state, 1 + extraargs, 1) != LUA_OK) {
+	if(call_lua(current_state, 1 + extraargs, 1, error_handler) != LUA_OK) {
 		pduel->handle_message(lua_get_string_or_empty(current_state, -1), OCG_LOG_TYPE_ERROR);
 	} else
 		result = lua_toboolean(current_state, -1);
-	lua_pop(current_state, 1);
+	lua_pop(current_state, 2);
 	return result;
 }
 lua_Integer interpreter::get_operation_value(card* pcard, int32_t findex, int32_t extraargs) {
 	if(!findex || lua_isnoneornil(current_state, findex))
 		return 0;
-	luaL_checkstack(current_state, extraargs + 2, nullptr);
-	lua_pushvalue(current_state, findex);
-	pushobject(current_state, pcard);
-	push_range_of_values(current_state, -(extraargs + 2), extraargs);
+	const auto error_handler = push_matching_call(current_state, pcard, findex, extraargs);
 	lua_Integer result = 0;
-	if(call_lua(current_state, 1 + extraargs, 1) != LUA_OK) {
+	if(call_lua(current_state, 1 + extraargs, 1, error_handler) != LUA_OK) {
 		pduel->handle_message(lua_get_string_or_empty(current_state, -1), OCG_LOG_TYPE_ERROR);
 	} else
 		result = lua_get<lua_Integer>(current_state, -1);
-	lua_pop(current_state, 1);
+	lua_pop(current_state, 2);
 	return result;
 }
 bool interpreter::get_operation_value(card* pcard, int32_t findex, int32_t extraargs, std::vector<lua_Integer>& result) {
@@ -519,14 +753,14 @@ lua_Integer interpreter::get_function_value(int32_t function, uint32_t param_cou
 		params.clear();
 		return 0;
 	}
-	if(!call_function(function, param_count, 1))
+	if(!call_function_single_result(function, param_count))
 		return 0;
 	lua_Integer result = 0;
 	if(lua_isboolean(current_state, -1))
 		result = lua_get<bool>(current_state, -1);
 	else
 		result = lua_get<lua_Integer, 0>(current_state, -1);
-	lua_pop(current_state, 1);
+	lua_pop(current_state, 2);
 	return result;
 }
 bool interpreter::get_function_value(int32_t function, uint32_t param_count, std::vector<lua_Integer>& result) {
@@ -580,11 +814,17 @@ int32_t interpreter::call_coroutine(int32_t function, uint32_t param_count, lua_
 	auto it = coroutines.find(function);
 	lua_State* rthread;
 	if (it == coroutines.end()) {
-		rthread = lua_newthread(lua_state);
-		const auto threadref = ensure_luaL_stack(luaL_ref, lua_state, LUA_REGISTRYINDEX);
+		int32_t threadref;
+		if(!coroutine_threads.empty()) {
+			std::tie(rthread, threadref) = coroutine_threads.back();
+			coroutine_threads.pop_back();
+		} else {
+			rthread = lua_newthread(lua_state);
+			threadref = ensure_luaL_stack(luaL_ref, lua_state, LUA_REGISTRYINDEX);
+		}
 		pushobject(rthread, function);
 		if(!lua_isfunction(rthread, -1)) {
-			ensure_luaL_stack(luaL_unref, lua_state, LUA_REGISTRYINDEX, threadref);
+			release_coroutine_thread(rthread, threadref);
 			return ret_error(R"("CallCoroutine": attempt to call an error function)");
 		}
 		++call_depth;
@@ -592,9 +832,9 @@ int32_t interpreter::call_coroutine(int32_t function, uint32_t param_count, lua_
 		it = ret.first;
 	} else {
 		if(step == 0) {
-			auto ref = it->second.second;
+			auto [thread, ref] = it->second;
 			coroutines.erase(it);
-			ensure_luaL_stack(luaL_unref, lua_state, LUA_REGISTRYINDEX, ref);
+			release_coroutine_thread(thread, ref);
 			--call_depth;
 			if(call_depth == 0) {
 				pduel->restore_assumes();
@@ -607,6 +847,7 @@ int32_t interpreter::call_coroutine(int32_t function, uint32_t param_count, lua_
 	auto prev_state = std::exchange(current_state, rthread);
 	auto [result, nresults] = resume_coroutine(current_state, prev_state, param_count);
 	current_state = prev_state;
+	check_memory_error(result);
 	if(result == LUA_YIELD)
 		return COROUTINE_YIELD;
 	if(result != LUA_OK) {
@@ -622,16 +863,51 @@ int32_t interpreter::call_coroutine(int32_t function, uint32_t param_count, lua_
 	}
 	auto ref = it->second.second;
 	coroutines.erase(it);
-	ensure_luaL_stack(luaL_unref, lua_state, LUA_REGISTRYINDEX, ref);
+	release_coroutine_thread(rthread, ref);
 	--call_depth;
 	if(call_depth == 0) {
 		pduel->restore_assumes();
 	}
 	return (result == LUA_OK) ? COROUTINE_FINISH : COROUTINE_ERROR;
 }
-int32_t interpreter::clone_lua_ref(int32_t lua_ref) {
-	lua_rawgeti(current_state, LUA_REGISTRYINDEX, lua_ref);
-	return ensure_luaL_stack(luaL_ref, current_state, LUA_REGISTRYINDEX);
+// puts back a thread used by call_coroutine in the pool, so that the following calls
+// don't have to allocate a new thread and its stack every time
+void interpreter::release_coroutine_thread(lua_State* thread, int32_t threadref) {
+	static constexpr size_t max_pooled_threads = 16;
+	if(lua_status(thread) != LUA_OK) {
+		// the coroutine errored or is still suspended, reset it so that it can run a new function
+#if LUA_VERSION_NUM <= 503
+		// lua 5.3 has no way to reset a thread, drop it
+		ensure_luaL_stack(luaL_unref, lua_state, LUA_REGISTRYINDEX, threadref);
+		return;
+#elif LUA_VERSION_RELEASE_NUM >= 50406
+		lua_closethread(thread, lua_state);
+#else
+		lua_resetthread(thread);
+#endif
+	}
+	if(coroutine_threads.size() >= max_pooled_threads) {
+		ensure_luaL_stack(luaL_unref, lua_state, LUA_REGISTRYINDEX, threadref);
+		return;
+	}
+	lua_settop(thread, 0);
+	coroutine_threads.emplace_back(thread, threadref);
+}
+/*
+	Effect clones share the lua references of the functions (and label object) of the effect they were
+	cloned from instead of creating new ones, the reference is freed once its last owner releases it.
+*/
+int32_t interpreter::share_lua_ref(int32_t lua_ref) {
+	++shared_lua_refs[lua_ref];
+	return lua_ref;
+}
+void interpreter::release_lua_ref(int32_t lua_ref) {
+	if(auto it = shared_lua_refs.find(lua_ref); it != shared_lua_refs.end()) {
+		if(--it->second == 0)
+			shared_lua_refs.erase(it);
+		return;
+	}
+	ensure_luaL_stack(luaL_unref, lua_state, LUA_REGISTRYINDEX, lua_ref);
 }
 int32_t interpreter::strong_from_weak_ref(int32_t weak_lua_ref) {
 	push_weak_ref(current_state, weak_lua_ref);
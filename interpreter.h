@@ -9,12 +9,13 @@
 
 // Due to longjmp behaviour, we must build Lua as C++ to avoid UB
 #include <cstdio> //std::snprintf
-#include <list>
 #include <type_traits> //std::is_integral_v
 #include <unordered_map>
 #include <utility> //std::forward
 #include <vector>
 #include "common.h"
+#include "containers_fwd.h"
+#include "lua_allocator.h"
 #include "lua_obj.h"
 #include "ocgapi_types.h"
 #include "scriptlib.h"
@@ -39,33 +40,64 @@ public:
 private:
 	void add_param(lua_param param, LuaParam type, bool front) {
 		if(front)
-			params.emplace_front(param, type);
+			params.emplace(params.begin(), param, type);
 		else
 			params.emplace_back(param, type);
 	}
 public:
-	using param_list = std::list<std::pair<lua_param, LuaParam>>;
+	// a call rarely takes more than a handful of parameters, the storage is reserved once
+	// and kept across calls (clear doesn't release it), so adding them never allocates
+	using param_list = std::vector<std::pair<lua_param, LuaParam>>;
 	
 	duel* pduel;
 	lua_State* lua_state;
 	lua_State* current_state;
 	param_list params;
 	coroutine_map coroutines;
+	// finished coroutine threads kept (with their registry reference) to be reused by call_coroutine
+	std::vector<std::pair<lua_State*, int32_t>> coroutine_threads;
 	int32_t no_action;
 	int32_t call_depth;
 	lua_invalid deleted;
 	int weak_lua_references;
+	int matching_batch_driver;
+	// registry references shared by an effect and its clones, with the number of owners besides the first one
+	std::unordered_map<int32_t, uint32_t> shared_lua_refs;
+	lua_allocator allocator;
+	uint32_t gc_step_budget;
+	uint32_t instruction_budget;
+	uint32_t instruction_ticks{}; // thousands of lua instructions run since the last reset_budget
+	uint64_t gc_collections{};
+	uint64_t gc_time{}; // in nanoseconds
 
 	interpreter(duel* pd, const OCG_DuelOptions& options, bool& valid_lua_lib);
 	~interpreter();
 
-	void register_card(card* pcard);
+	void register_card(card* pcard, bool lazy_init = false);
+	void run_initial_effect(card* pcard);
+	// field ids reserved for the initial_effect of each lazily initialized card
+	static constexpr uint32_t lazy_field_id_reserve = 256;
 	void register_effect(effect* peffect);
 	void unregister_effect(effect* peffect);
 	void register_group(group* pgroup);
 	void register_obj(lua_obj* obj, const char* tablename, bool weak);
+	void unregister_group(group* pgroup);
 
-	void collect(bool full = false);
+	bool collect(bool full = false);
+	void collect_step_budget();
+	void reset_budget() {
+		instruction_ticks = 0;
+	}
+	bool budget_exhausted() const {
+		return instruction_budget != 0 && instruction_ticks >= instruction_budget;
+	}
+	// flags the duel when a lua call failed because the memory limit was hit even after
+	// the emergency collection, returns the result unchanged
+	int check_memory_error(int result) {
+		if(result == LUA_ERRMEM)
+			allocator.limit_reached = true;
+		return result;
+	}
 
 	bool load_script(const char* buffer, int len = 0, const char* script_name = nullptr);
 	bool load_card_script(uint32_t code);
@@ -82,26 +114,53 @@ public:
 		}
 		add_param(p, type, front);
 	}
-	void push_param(lua_State* L, bool is_coroutine = false);
+	void push_param(lua_State* L, bool is_coroutine = false, int32_t pushed_before = 1);
 	bool call_function(int32_t f, uint32_t param_count, int32_t ret_count);
 	bool call_card_function(card* pcard, const char* f, uint32_t param_count, int32_t ret_count, bool forced = true);
 	bool call_code_function(uint32_t code, const char* f, uint32_t param_count, int32_t ret_count);
 	bool check_condition(int32_t f, uint32_t param_count);
 	bool check_matching(card* pcard, int32_t findex, int32_t extraargs);
+	void check_matching(const card_vector& cards, int32_t findex, int32_t extraargs, std::vector<bool>& result);
+	static constexpr size_t matching_batch_threshold = 8;
+	/*
+		Calls callback(pcard, matched) for every card in cards, matched being the result of the filter at findex.
+		When there are enough cards, the filter is evaluated for all of them with a single lua call.
+		The callback is allowed to remove the current card from cards.
+	*/
+	template<typename T, typename F>
+	void check_matching_each(const T& cards, int32_t findex, int32_t extraargs, F&& callback) {
+		if(cards.size() < matching_batch_threshold) {
+			for(auto it = cards.begin(), end = cards.end(); it != end;) {
+				auto* pcard = *it++;
+				callback(pcard, check_matching(pcard, findex, extraargs));
+			}
+			return;
+		}
+		const card_vector candidates(cards.begin(), cards.end());
+		std::vector<bool> matching;
+		check_matching(candidates, findex, extraargs, matching);
+		for(size_t i = 0; i < candidates.size(); ++i)
+			callback(candidates[i], matching[i]);
+	}
 	bool check_matching_table(card* pcard, int32_t findex, int32_t table_index);
 	lua_Integer get_operation_value(card* pcard, int32_t findex, int32_t extraargs);
 	bool get_operation_value(card* pcard, int32_t findex, int32_t extraargs, std::vector<lua_Integer>& result);
 	lua_Integer get_function_value(int32_t f, uint32_t param_count);
 	bool get_function_value(int32_t f, uint32_t param_count, std::vector<lua_Integer>& result);
 	int32_t call_coroutine(int32_t f, uint32_t param_count, lua_Integer* yield_value, uint16_t step);
-	int32_t clone_lua_ref(int32_t lua_ref);
+	void release_coroutine_thread(lua_State* thread, int32_t threadref);
+	int32_t share_lua_ref(int32_t lua_ref);
+	void release_lua_ref(int32_t lua_ref);
 	int32_t strong_from_weak_ref(int32_t weak_lua_ref);
 	void push_weak_ref(lua_State* L, int32_t weak_lua_ref);
 	void* get_ref_object(int32_t ref_handler);
 	bool call_function(int param_count, int ret_count);
+	bool call_function_single_result(int32_t f, uint32_t param_count);
 	inline bool ret_fail(const char* message);
 	inline bool ret_fail(const char* message, bool error);
 	inline int call_lua(lua_State* L, int nargs, int nresults);
+	inline int call_lua(lua_State* L, int nargs, int nresults, int error_handler_index);
+	static int push_error_handler(lua_State* L);
 
 	static void pushobject(lua_State* L, lua_obj* obj);
 	static void pushobject(lua_State* L, int32_t lua_ptr);
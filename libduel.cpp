@@ -48,6 +48,10 @@ LUA_STATIC_FUNCTION(GetRandomGroup) {
 	if(count <= 0) count = 0;
 	else if(count > 50) count = 50;
 	group* pgroup = pduel->new_group();
+	if(!pduel->cards_data) {
+		interpreter::pushobject(L, pgroup);
+		return 1;
+	}
 	uint32_t index = 0;
 	std::unordered_map<int32_t, uint32_t>* p_codes = new std::unordered_map<int32_t, uint32_t>();
 
@@ -242,9 +246,7 @@ LUA_STATIC_FUNCTION(SetLP) {
 		pduel->game_field->process_instant_event();
 	}
     //////////kdiy/////////
-	auto message = pduel->new_message(MSG_LPUPDATE);
-	message->write<uint8_t>(p);
-	message->write<uint32_t>(lp);
+	pduel->write_message<MSG_LPUPDATE>(p, lp);
 	return 0;
 }
 LUA_STATIC_FUNCTION(GetTurnPlayer) {
@@ -1531,11 +1533,13 @@ LUA_STATIC_FUNCTION(EquipComplete) {
 	if (etargets.size() == 0)
 		return 0;
 	field->adjust_instant();
+	auto ng = pduel->new_group(core.equiping_cards);
+	ng->is_readonly = true;
 	for(auto& equip_target : etargets) {
-		field->raise_single_event(equip_target, &core.equiping_cards, EVENT_EQUIP,
+		field->raise_single_event(equip_target, ng, EVENT_EQUIP,
 		                          core.reason_effect, 0, core.reason_player, PLAYER_NONE, 0);
 	}
-	field->raise_event(core.equiping_cards, EVENT_EQUIP,
+	field->raise_event(ng, EVENT_EQUIP,
 	                               core.reason_effect, 0, core.reason_player, PLAYER_NONE, 0);
 	core.hint_timing[0] |= TIMING_EQUIP;
 	core.hint_timing[1] |= TIMING_EQUIP;
@@ -1711,9 +1715,13 @@ LUA_STATIC_FUNCTION(ShuffleSetCard) {
 		ms[ct] = pcard;
 		seq[ct] = current.sequence;
 	}
-	for(int32_t i = ct - 1; i > 0; --i) {
-		int32_t s = pduel->get_next_integer(0, i);
-		std::swap(ms[i], ms[s]);
+	if(pduel->fast_rng) {
+		pduel->shuffle(ms, ct);
+	} else {
+		for(int32_t i = ct - 1; i > 0; --i) {
+			int32_t s = pduel->get_next_integer(0, i);
+			std::swap(ms[i], ms[s]);
+		}
 	}
 	auto& field = pduel->game_field;
 	auto& list = (loc == LOCATION_MZONE) ? field->player[tp].list_mzone : field->player[tp].list_szone;
@@ -2244,6 +2252,8 @@ LUA_STATIC_FUNCTION(GetFieldCard) {
 	card* pcard = pduel->game_field->get_field_card(playerid, location, sequence);
 	if(!pcard || pcard->get_status(STATUS_SUMMONING | STATUS_SPSUMMON_STEP))
 		return 0;
+	if(pcard->pending_initial_effect)
+		pduel->lua->run_initial_effect(pcard);
 	interpreter::pushobject(L, pcard);
 	return 1;
 }
@@ -2584,6 +2594,7 @@ LUA_STATIC_FUNCTION(GetFieldGroupCount) {
 LUA_STATIC_FUNCTION(GetDecktopGroup) {
 	check_param_count(L, 2);
 	auto playerid = lua_get<uint8_t>(L, 1);
+	pduel->game_field->init_deck_cards(playerid);
 	auto& main = pduel->game_field->player[playerid].list_main;
 	const auto count = std::min<size_t>(lua_get<uint32_t>(L, 2), main.size());
 	const auto offset = main.size() - count;
@@ -2594,6 +2605,7 @@ LUA_STATIC_FUNCTION(GetDecktopGroup) {
 LUA_STATIC_FUNCTION(GetDeckbottomGroup) {
 	check_param_count(L, 2);
 	auto playerid = lua_get<uint8_t>(L, 1);
+	pduel->game_field->init_deck_cards(playerid);
 	auto& main = pduel->game_field->player[playerid].list_main;
 	const auto count = std::min<size_t>(lua_get<uint32_t>(L, 2), main.size());
 	auto pgroup = pduel->new_group(main.begin(), main.begin() + count);
@@ -3349,8 +3361,8 @@ LUA_STATIC_FUNCTION(Overlay) {
 	bool send_materials_to_grave = lua_get<bool, false>(L, 3);
 	/////kdiy////////
 	auto reason = lua_get<uint32_t, 0>(L, 4);
-	card_set tcset;
-	tcset.insert(target);
+	auto tgroup = pduel->new_group(target);
+	tgroup->is_readonly = true;
 	/////kdiy////////
 	if(pcard) {
 		if(pcard == target)
@@ -3364,7 +3376,7 @@ LUA_STATIC_FUNCTION(Overlay) {
 		/////kdiy////////
 		pduel->game_field->xyz_overlay(target, pcard, send_materials_to_grave);
 		/////kdiy////////
-		pduel->game_field->raise_single_event(pcard, &tcset, EVENT_OVERLAY, pcard->current.reason_effect, pcard->current.reason, pcard->current.reason_player, tp, 0);
+		pduel->game_field->raise_single_event(pcard, tgroup, EVENT_OVERLAY, pcard->current.reason_effect, pcard->current.reason, pcard->current.reason_player, tp, 0);
 		pduel->game_field->process_single_event();
 		pduel->game_field->process_instant_event();
 		/////kdiy////////
@@ -3380,7 +3392,7 @@ LUA_STATIC_FUNCTION(Overlay) {
 			else
 			    pcard->current.reason = reason | REASON_RULE;
 			pduel->game_field->xyz_overlay(target, pcard, send_materials_to_grave);
-			pduel->game_field->raise_single_event(pcard, &tcset, EVENT_OVERLAY, pcard->current.reason_effect, pcard->current.reason, pcard->current.reason_player, tp, 0);
+			pduel->game_field->raise_single_event(pcard, tgroup, EVENT_OVERLAY, pcard->current.reason_effect, pcard->current.reason, pcard->current.reason_player, tp, 0);
 		}
 		pduel->game_field->process_single_event();
 		pduel->game_field->process_instant_event();
@@ -3452,10 +3464,7 @@ LUA_STATIC_FUNCTION(Hint) {
 	auto desc = lua_get<uint64_t>(L, 3);
 	if(htype == HINT_OPSELECTED)
 		playerid = 1 - playerid;
-	auto message = pduel->new_message(MSG_HINT);
-	message->write<uint8_t>(htype);
-	message->write<uint8_t>(playerid);
-	message->write<uint64_t>(desc);
+	pduel->write_message<MSG_HINT>(htype, playerid, desc);
 	return 0;
 }
 LUA_STATIC_FUNCTION(HintSelection) {
@@ -3515,10 +3524,7 @@ LUA_STATIC_FUNCTION(SelectOption) {
 		auto playerid = lua_get<uint8_t>(L, 1);
 		bool sel_hint = lua_get<bool, true>(L, 2);
 		if(sel_hint && !pduel->game_field->core.select_options.empty()) {
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_OPSELECTED);
-			message->write<uint8_t>(playerid);
-			message->write<uint64_t>(pduel->game_field->core.select_options[pduel->game_field->returns.at<int32_t>(0)]);
+			pduel->write_message<MSG_HINT>(HINT_OPSELECTED, playerid, pduel->game_field->core.select_options[pduel->game_field->returns.at<int32_t>(0)]);
 		}
 		lua_pushinteger(L, pduel->game_field->returns.at<int32_t>(0));
 		return 1;
@@ -3876,10 +3882,7 @@ LUA_STATIC_FUNCTION(AnnounceType) {
 	pduel->game_field->emplace_process<Processors::SelectOption>(playerid);
 	return yieldk({
 		auto playerid = lua_get<uint8_t>(L, 1);
-		auto message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_OPSELECTED);
-		message->write<uint8_t>(playerid);
-		message->write<uint64_t>(pduel->game_field->core.select_options[pduel->game_field->returns.at<int32_t>(0)]);
+		pduel->write_message<MSG_HINT>(HINT_OPSELECTED, playerid, pduel->game_field->core.select_options[pduel->game_field->returns.at<int32_t>(0)]);
 		lua_pushinteger(L, pduel->game_field->returns.at<int32_t>(0));
 		return 1;
 	});
@@ -3904,10 +3907,7 @@ LUA_STATIC_FUNCTION(AnnounceCoin) {
 	check_param_count(L, 1);
 	auto playerid = lua_get<uint8_t>(L, 1);
 	auto desc = lua_get<uint64_t, 552>(L, 2);
-	auto message = pduel->new_message(MSG_HINT);
-	message->write<uint8_t>(HINT_SELECTMSG);
-	message->write<uint8_t>(playerid);
-	message->write<uint64_t>(desc);
+	pduel->write_message<MSG_HINT>(HINT_SELECTMSG, playerid, desc);
 	pduel->game_field->core.select_options.clear();
 	pduel->game_field->core.select_options.push_back(60);
 	pduel->game_field->core.select_options.push_back(61);
@@ -3915,10 +3915,7 @@ LUA_STATIC_FUNCTION(AnnounceCoin) {
 	return yieldk({
 		if(/*bool sel_hint = */lua_get<bool, true>(L, 2)) {
 			auto playerid = lua_get<uint8_t>(L, 1);
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_OPSELECTED);
-			message->write<uint8_t>(playerid);
-			message->write<uint64_t>(pduel->game_field->core.select_options[pduel->game_field->returns.at<int32_t>(0)]);
+			pduel->write_message<MSG_HINT>(HINT_OPSELECTED, playerid, pduel->game_field->core.select_options[pduel->game_field->returns.at<int32_t>(0)]);
 		}
 		lua_pushinteger(L, 1 - pduel->game_field->returns.at<int32_t>(0));
 		return 1;
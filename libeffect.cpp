@@ -204,7 +204,7 @@ LUA_FUNCTION(SetLabel) {
 LUA_FUNCTION(SetLabelObject) {
 	check_param_count(L, 2);
 	if(self->label_object)
-		ensure_luaL_stack(luaL_unref, L, LUA_REGISTRYINDEX, self->label_object);
+		pduel->lua->release_lua_ref(self->label_object);
 	self->label_object = 0;
 	if(lua_isnoneornil(L, 2))
 		return 0;
@@ -233,7 +233,7 @@ LUA_FUNCTION(SetCondition) {
 	check_param_count(L, 2);
 	const auto findex = lua_get<function, true>(L, 2);
 	if(self->condition)
-		ensure_luaL_stack(luaL_unref, L, LUA_REGISTRYINDEX, self->condition);
+		pduel->lua->release_lua_ref(self->condition);
 	self->condition = interpreter::get_function_handle(L, findex);
 	return 0;
 }
@@ -241,7 +241,7 @@ LUA_FUNCTION(SetTarget) {
 	check_param_count(L, 2);
 	const auto findex = lua_get<function, true>(L, 2);
 	if(self->target)
-		ensure_luaL_stack(luaL_unref, L, LUA_REGISTRYINDEX, self->target);
+		pduel->lua->release_lua_ref(self->target);
 	self->target = interpreter::get_function_handle(L, findex);
 	return 0;
 }
@@ -249,14 +249,14 @@ LUA_FUNCTION(SetCost) {
 	check_param_count(L, 2);
 	const auto findex = lua_get<function, true>(L, 2);
 	if(self->cost)
-		ensure_luaL_stack(luaL_unref, L, LUA_REGISTRYINDEX, self->cost);
+		pduel->lua->release_lua_ref(self->cost);
 	self->cost = interpreter::get_function_handle(L, findex);
 	return 0;
 }
 LUA_FUNCTION(SetValue) {
 	check_param_count(L, 2);
 	if(self->value && self->is_flag(EFFECT_FLAG_FUNC_VALUE))
-		ensure_luaL_stack(luaL_unref, L, LUA_REGISTRYINDEX, self->value);
+		pduel->lua->release_lua_ref(self->value);
 	if (lua_isfunction(L, 2)) {
 		self->value = interpreter::get_function_handle(L, 2);
 		self->flag[0] |= EFFECT_FLAG_FUNC_VALUE;
@@ -283,7 +283,7 @@ LUA_FUNCTION(SetValue) {
 LUA_FUNCTION(SetOperation) {
 	check_param_count(L, 2);
 	if(self->operation)
-		ensure_luaL_stack(luaL_unref, L, LUA_REGISTRYINDEX, self->operation);
+		pduel->lua->release_lua_ref(self->operation);
 	self->operation = 0;
 	const auto findex = lua_get<function>(L, 2);
 	if(findex)
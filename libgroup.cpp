@@ -134,11 +134,10 @@ LUA_FUNCTION(Filter) {
 	}
 	auto new_group = pduel->new_group();
 	uint32_t extraargs = lua_gettop(L) - 3;
-	for(auto& pcard : cset) {
-		if(pduel->lua->check_matching(pcard, findex, extraargs)) {
+	pduel->lua->check_matching_each(cset, findex, extraargs, [&](card* pcard, bool matched) {
+		if(matched)
 			new_group->container.insert(pcard);
-		}
-	}
+	});
 	interpreter::pushobject(L, new_group);
 	return 1;
 }
@@ -150,36 +149,15 @@ LUA_FUNCTION(Match) {
 	uint32_t extraargs = lua_gettop(L) - 3;
 	auto& cset = self->container;
 	if(auto [pexception, pexgroup] = lua_get_card_or_group<true>(L, 3); pexception) {
-		for(auto cit = cset.begin(), cend = cset.end(); cit != cend; ) {
-			auto rm = cit++;
-			auto* pcard = *rm;
-			if(pcard == pexception || !pduel->lua->check_matching(pcard, findex, extraargs))
-				cset.erase(rm);
-		}
+		cset.erase(pexception);
 	} else if(pexgroup) {
-		auto should_remove = [pexbegin = pexgroup->container.cbegin(), pexend = pexgroup->container.cend()](card* pcard) mutable {
-			if(pexbegin == pexend)
-				return false;
-			if(*pexbegin == pcard) {
-				++pexbegin;
-				return true;
-			}
-			return false;
-		};
-		for(auto cit = cset.begin(), cend = cset.end(); cit != cend; ) {
-			auto rm = cit++;
-			auto* pcard = *rm;
-			if(should_remove(pcard) || !pduel->lua->check_matching(pcard, findex, extraargs))
-				cset.erase(rm);
-		}
-	} else {
-		for(auto cit = cset.begin(), cend = cset.end(); cit != cend; ) {
-			auto rm = cit++;
-			auto* pcard = *rm;
-			if(!pduel->lua->check_matching(pcard, findex, extraargs))
-				cset.erase(rm);
-		}
+		for(auto& pcard : pexgroup->container)
+			cset.erase(pcard);
 	}
+	pduel->lua->check_matching_each(cset, findex, extraargs, [&cset](card* pcard, bool matched) {
+		if(!matched)
+			cset.erase(pcard);
+	});
 	interpreter::pushobject(L, self);
 	return 1;
 }
@@ -195,10 +173,10 @@ LUA_FUNCTION(FilterCount) {
 	}
 	uint32_t extraargs = lua_gettop(L) - 3;
 	uint32_t count = 0;
-	for (auto& pcard : cset) {
-		if(pduel->lua->check_matching(pcard, findex, extraargs))
+	pduel->lua->check_matching_each(cset, findex, extraargs, [&count](card*, bool matched) {
+		if(matched)
 			++count;
-	}
+	});
 	lua_pushinteger(L, count);
 	return 1;
 }
@@ -226,10 +204,10 @@ LUA_FUNCTION(FilterSelect) {
 	auto max = lua_get<uint16_t>(L, 5);
 	uint32_t extraargs = lua_gettop(L) - lastarg;
 	pduel->game_field->core.select_cards.clear();
-	for(auto& pcard : cset) {
-		if(pduel->lua->check_matching(pcard, findex, extraargs))
-			pduel->game_field->core.select_cards.push_back(pcard);
-	}
+	pduel->lua->check_matching_each(cset, findex, extraargs, [&select_cards = pduel->game_field->core.select_cards](card* pcard, bool matched) {
+		if(matched)
+			select_cards.push_back(pcard);
+	});
 	pduel->game_field->emplace_process<Processors::SelectCard>(playerid, cancelable, min, max);
 	return push_return_cards(L, cancelable);
 }
@@ -314,7 +292,14 @@ LUA_FUNCTION(RandomSelect) {
 	}
 	if(count == self->container.size())
 		newgroup->container = self->container;
-	else {
+	else if(pduel->fast_rng) {
+		// partial Fisher-Yates, unlike the loop below every draw selects a different card
+		card_vector cards(self->container.begin(), self->container.end());
+		for(size_t i = 0; i < count; ++i) {
+			std::swap(cards[i], cards[pduel->get_next_integer(static_cast<int32_t>(i), static_cast<int32_t>(cards.size() - 1))]);
+			newgroup->container.insert(cards[i]);
+		}
+	} else {
 		while(newgroup->container.size() < count) {
 			int32_t i = pduel->get_next_integer(0, (int32_t)self->container.size() - 1);
 			auto cit = self->container.begin();
@@ -606,36 +591,22 @@ LUA_FUNCTION(Remove) {
 	self->is_iterator_dirty = true;
 	uint32_t extraargs = lua_gettop(L) - 3;
 	auto& cset = self->container;
-	if(auto [pexception, pexgroup] = lua_get_card_or_group<true>(L, 3); pexception) {
-		for(auto cit = cset.begin(), cend = cset.end(); cit != cend; ) {
-			auto rm = cit++;
-			auto* pcard = *rm;
-			if(pcard != pexception && pduel->lua->check_matching(pcard, findex, extraargs))
-				cset.erase(rm);
-		}
-	} else if(pexgroup) {
-		auto should_keep = [pexbegin = pexgroup->container.cbegin(), pexend = pexgroup->container.cend()](card* pcard) mutable {
-			if(pexbegin == pexend)
-				return false;
-			if(*pexbegin == pcard) {
-				++pexbegin;
-				return true;
-			}
-			return false;
-		};
-		for(auto cit = cset.begin(), cend = cset.end(); cit != cend; ) {
-			auto rm = cit++;
-			auto* pcard = *rm;
-			if(!should_keep(pcard) && pduel->lua->check_matching(pcard, findex, extraargs))
-				cset.erase(rm);
+	auto remove_matching = [&cset](card* pcard, bool matched) {
+		if(matched)
+			cset.erase(pcard);
+	};
+	if(auto [pexception, pexgroup] = lua_get_card_or_group<true>(L, 3); pexception || pexgroup) {
+		// the excluded cards stay in the group without being checked,
+		// the others are collected apart to be checked
+		card_vector candidates;
+		candidates.reserve(cset.size());
+		for(auto& pcard : cset) {
+			if(pcard != pexception && !(pexgroup && pexgroup->has_card(pcard)))
+				candidates.push_back(pcard);
 		}
+		pduel->lua->check_matching_each(candidates, findex, extraargs, remove_matching);
 	} else {
-		for(auto cit = cset.begin(), cend = cset.end(); cit != cend; ) {
-			auto rm = cit++;
-			auto* pcard = *rm;
-			if(pduel->lua->check_matching(pcard, findex, extraargs))
-				cset.erase(rm);
-		}
+		pduel->lua->check_matching_each(cset, findex, extraargs, remove_matching);
 	}
 	interpreter::pushobject(L, self);
 	return 1;
@@ -762,15 +733,12 @@ LUA_FUNCTION(Split) {
 		}
 	}
 	uint32_t extraargs = lua_gettop(L) - 3;
-	for(auto it = cset.begin(); it != cset.end();) {
-		auto pcard = *it;
-		if(pduel->lua->check_matching(pcard, findex, extraargs)) {
-			++it;
-		} else {
+	pduel->lua->check_matching_each(cset, findex, extraargs, [&](card* pcard, bool matched) {
+		if(!matched) {
 			notmatching.insert(pcard);
-			it = cset.erase(it);
+			cset.erase(pcard);
 		}
-	}
+	});
 	interpreter::pushobject(L, pduel->new_group(std::move(cset)));
 	interpreter::pushobject(L, pduel->new_group(std::move(notmatching)));
 	return 2;
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2026, Edoardo Lolletti (edo9300) <edoardo762@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#include <algorithm> //std::max, std::min
+#include <cstdlib> //std::malloc, std::realloc, std::free
+#include <cstring> //std::memcpy
+#include <utility> //std::exchange
+#include "lua_allocator.h"
+
+lua_allocator::~lua_allocator() {
+	for(auto* chunk : chunks)
+		std::free(chunk);
+}
+
+void* lua_allocator::allocate_pooled(std::size_t size_class) {
+	if(auto* block = free_lists[size_class]; block != nullptr) {
+		free_lists[size_class] = block->next;
+		return block;
+	}
+	const auto block_size = (size_class + 1) * granularity;
+	if(static_cast<std::size_t>(chunk_end - chunk_current) < block_size) {
+		auto* chunk = static_cast<char*>(std::malloc(chunk_size));
+		if(chunk == nullptr)
+			return nullptr;
+		chunks.push_back(chunk);
+		chunk_current = chunk;
+		chunk_end = chunk + chunk_size;
+	}
+	return std::exchange(chunk_current, chunk_current + block_size);
+}
+
+void lua_allocator::free_pooled(void* ptr, std::size_t size_class) {
+	auto* block = static_cast<free_block*>(ptr);
+	block->next = free_lists[size_class];
+	free_lists[size_class] = block;
+}
+
+void* lua_allocator::reallocate(void* ptr, std::size_t osize, std::size_t nsize) {
+	const bool old_pooled = ptr != nullptr && osize <= max_pooled_size;
+	const bool new_pooled = nsize <= max_pooled_size;
+	void* ret = nullptr;
+	if(nsize == 0) {
+		if(old_pooled)
+			free_pooled(ptr, get_size_class(osize));
+		else
+			std::free(ptr);
+	} else if(ptr == nullptr) {
+		ret = new_pooled ? allocate_pooled(get_size_class(nsize)) : std::malloc(nsize);
+		if(ret == nullptr)
+			return nullptr;
+	} else if(old_pooled && new_pooled && get_size_class(osize) == get_size_class(nsize)) {
+		ret = ptr;
+	} else if(!old_pooled && !new_pooled) {
+		ret = std::realloc(ptr, nsize);
+		if(ret == nullptr)
+			return nullptr;
+	} else if((ret = new_pooled ? allocate_pooled(get_size_class(nsize)) : std::malloc(nsize)) != nullptr) {
+		std::memcpy(ret, ptr, std::min(osize, nsize));
+		if(old_pooled)
+			free_pooled(ptr, get_size_class(osize));
+		else
+			std::free(ptr);
+	} else if(nsize > osize) {
+		return nullptr;
+	} else if(old_pooled) {
+		// lua requires shrinking a block to never fail, if no chunk is available
+		// a pooled block is kept as is, it's big enough for its new size class
+		ret = ptr;
+	} else {
+		// same for a system block, that is shrunk to its new size class and
+		// handed to the pool as a chunk of its own, to be freed with the others
+		const auto block_size = (get_size_class(nsize) + 1) * granularity;
+		// a failed realloc leaves the block untouched, it's then adopted with its old size
+		if(auto* shrunk = std::realloc(ptr, block_size); shrunk != nullptr)
+			ptr = shrunk;
+		ret = ptr;
+		chunks.push_back(ret);
+	}
+	if(ptr == nullptr)
+		osize = 0;
+	current = current - osize + nsize;
+	peak = std::max(peak, current);
+	return ret;
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2026, Edoardo Lolletti (edo9300) <edoardo762@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#ifndef LUA_ALLOCATOR_H_
+#define LUA_ALLOCATOR_H_
+
+#include <array>
+#include <cstddef> //std::size_t
+#include <cstdint>
+#include <vector>
+
+/*
+	Memory allocator used by the lua state of a duel.
+	Small blocks (the vast majority of what lua allocates: strings, tables, closures, userdata)
+	are served from per size class free lists carved out of big chunks owned by the allocator,
+	bigger blocks are forwarded to the system allocator.
+	Every duel has its own instance, so no synchronization is needed and duels running
+	on different threads don't contend on the global heap for their small allocations.
+	Lua always passes the original size of a block when resizing or freeing it, so
+	no per block header is needed to know its size class.
+*/
+class lua_allocator {
+public:
+	explicit lua_allocator(uint64_t limit) : limit(limit) {}
+	~lua_allocator();
+	lua_allocator(const lua_allocator&) = delete;
+	lua_allocator& operator=(const lua_allocator&) = delete;
+
+	// same semantics as a lua_Alloc function, ptr must be nullptr if osize is not a size
+	void* reallocate(void* ptr, std::size_t osize, std::size_t nsize);
+	bool would_exceed_limit(std::size_t increase) const {
+		return limit != 0 && current + increase > limit;
+	}
+
+	uint64_t current{};
+	uint64_t peak{};
+	uint64_t limit;
+	bool limit_reached{ false };
+private:
+	static constexpr std::size_t granularity = 16;
+	static constexpr std::size_t max_pooled_size = 256;
+	static constexpr std::size_t chunk_size = 32 * 1024;
+	static constexpr std::size_t size_classes = max_pooled_size / granularity;
+	struct free_block {
+		free_block* next;
+	};
+
+	static constexpr std::size_t get_size_class(std::size_t size) {
+		return (size - 1) / granularity;
+	}
+	void* allocate_pooled(std::size_t size_class);
+	void free_pooled(void* ptr, std::size_t size_class);
+
+	std::array<free_block*, size_classes> free_lists{};
+	std::vector<void*> chunks;
+	char* chunk_current{};
+	char* chunk_end{};
+};
+
+#endif /* LUA_ALLOCATOR_H_ */
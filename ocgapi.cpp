@@ -6,6 +6,8 @@
  */
 #include <cstring> //std::memcpy
 #include <new> //std::nothrow
+#include <string>
+#include <utility> //std::exchange
 #include <vector>
 #include "ocgapi.h"
 #include "interpreter.h"
@@ -13,6 +15,154 @@
 #include "field.h"
 #include "effect.h"
 
+template<typename T>
+void insert_value_int(std::vector<uint8_t>& vec, T val) {
+	const auto vec_size = vec.size();
+	const auto val_size = sizeof(T);
+	vec.resize(vec_size + val_size);
+	std::memcpy(&vec[vec_size], &val, val_size);
+}
+template<typename T, typename T2>
+ForceInline void insert_value(std::vector<uint8_t>& vec, T2 val) {
+	insert_value_int<T>(vec, static_cast<T>(val));
+}
+
+/*
+	The serialized state of a duel is not a snapshot, but a replay log of the api calls that changed
+	it: the options it was created with, followed by one record per call. Deserializing replays them
+	on a new duel, the core being deterministic this gives back exactly the same state, including the
+	lua one, at the cost of running the whole duel again.
+	Named scripts are only stored by name and read again through the script reader when replayed.
+*/
+namespace {
+constexpr uint32_t journal_magic = 0x4A47434F; // "OCGJ"
+constexpr uint16_t journal_version = 4;
+
+enum class JOURNAL_RECORD : uint8_t {
+	NEW_CARD,
+	START,
+	PROCESS,
+	RESPONSE,
+	LOAD_SCRIPT,
+	QUERY,
+	QUERY_LOCATION,
+};
+
+template<typename T, typename F>
+bool visit_journal_options(T& options, F&& visit) {
+	return visit(options.seed[0]) && visit(options.seed[1]) && visit(options.seed[2]) && visit(options.seed[3])
+		&& visit(options.flags)
+		&& visit(options.team1.startingLP) && visit(options.team1.startingDrawCount) && visit(options.team1.drawCountPerTurn)
+		&& visit(options.team2.startingLP) && visit(options.team2.startingDrawCount) && visit(options.team2.drawCountPerTurn)
+		&& visit(options.enableUnsafeLibraries) && visit(options.luaMemoryLimit)
+		&& visit(options.gc.mode) && visit(options.gc.pause) && visit(options.gc.stepMultiplier) && visit(options.gc.stepSize)
+		&& visit(options.gc.minorMultiplier) && visit(options.gc.majorMultiplier)
+		&& visit(options.gc.groupThreshold) && visit(options.gc.stepBudget)
+		&& visit(options.budget.steps) && visit(options.budget.luaInstructions);
+}
+
+template<typename T, typename F>
+bool visit_journal_card_info(T& info, F&& visit) {
+	return visit(info.team) && visit(info.duelist) && visit(info.code) && visit(info.con)
+		&& visit(info.loc) && visit(info.seq) && visit(info.pos);
+}
+
+class journal_reader {
+	const uint8_t* ptr;
+	const uint8_t* end;
+public:
+	journal_reader(const void* buffer, uint32_t length) :
+		ptr(static_cast<const uint8_t*>(buffer)), end(ptr + length) {}
+	template<typename T>
+	bool read(T& value) {
+		if(static_cast<size_t>(end - ptr) < sizeof(T))
+			return false;
+		std::memcpy(&value, ptr, sizeof(T));
+		ptr += sizeof(T);
+		return true;
+	}
+	const uint8_t* read_bytes(uint32_t size) {
+		if(static_cast<size_t>(end - ptr) < size)
+			return nullptr;
+		return std::exchange(ptr, ptr + size);
+	}
+	bool done() const {
+		return ptr == end;
+	}
+};
+
+void journal_begin(duel* pduel, const OCG_DuelOptions& options) {
+	auto& journal = pduel->journal;
+	journal.clear();
+	if(!(options.flags & DUEL_SERIALIZABLE))
+		return;
+	insert_value<uint32_t>(journal, journal_magic);
+	insert_value<uint16_t>(journal, journal_version);
+	visit_journal_options(options, [&journal](auto value) {
+		insert_value<decltype(value)>(journal, value);
+		return true;
+	});
+}
+
+// returns the journal to write the record in, or nullptr if the duel isn't being recorded
+// calls made while another recorded one is running (e.g. OCG_LoadScript from the script reader)
+// aren't recorded, as replaying the outer call makes them again
+std::vector<uint8_t>* journal_record(duel* pduel, JOURNAL_RECORD type) {
+	auto& journal = pduel->journal;
+	if(journal.empty() || pduel->journal_depth != 0)
+		return nullptr;
+	insert_value<uint8_t>(journal, type);
+	return &journal;
+}
+
+// writes a LOAD_SCRIPT record, a named script is stored by its name only, as the restoring
+// host provides the script reader, returns the offset of the result to fill after the load
+size_t journal_load_script(duel* pduel, const char* buffer, uint32_t length, const char* name) {
+	auto* journal = journal_record(pduel, JOURNAL_RECORD::LOAD_SCRIPT);
+	if(!journal)
+		return 0;
+	if(name) {
+		length = static_cast<uint32_t>(std::strlen(name));
+		buffer = name;
+	}
+	insert_value<uint8_t>(*journal, name != nullptr);
+	insert_value<uint32_t>(*journal, length);
+	journal->insert(journal->end(), buffer, buffer + length);
+	const auto result_offset = journal->size();
+	insert_value<uint8_t>(*journal, 0);
+	return result_offset;
+}
+
+struct journal_scope {
+	duel* pduel;
+	explicit journal_scope(duel* pduel) : pduel(pduel) {
+		++pduel->journal_depth;
+	}
+	~journal_scope() {
+		--pduel->journal_depth;
+	}
+};
+
+// runs processor steps until a response is needed, the duel ends or the budget is exhausted,
+// without a message handler it also stops as soon as a step generated some messages
+OCG_DuelStatus process_steps(duel* pduel, uint32_t& steps) {
+	while(true) {
+		if(pduel->lua->allocator.limit_reached) {
+			pduel->handle_message("The duel exceeded its lua memory limit and can't continue", OCG_LOG_TYPE_ERROR);
+			return OCG_DUEL_STATUS_END;
+		}
+		const auto flag = pduel->game_field->process();
+		++steps;
+		const bool generated = pduel->generate_buffer();
+		if(flag != OCG_DUEL_STATUS_CONTINUE || (generated && pduel->message_handler == nullptr))
+			return flag;
+		// every step leaves the processor in a state it can be resumed from
+		if(steps == pduel->process_step_budget || pduel->lua->budget_exhausted())
+			return OCG_DUEL_STATUS_YIELDED;
+	}
+}
+}
+
 OCGAPI void OCG_GetVersion(int* major, int* minor) {
 	if(major)
 		*major = OCG_VERSION_MAJOR;
@@ -20,18 +170,11 @@ OCGAPI void OCG_GetVersion(int* major, int* minor) {
 		*minor = OCG_VERSION_MINOR;
 }
 
-OCGAPI int OCG_CreateDuel(OCG_Duel* out_ocg_duel, const OCG_DuelOptions* options_ptr) {
-	if(out_ocg_duel == nullptr)
-		return OCG_DUEL_CREATION_NO_OUTPUT;
-	auto options = *options_ptr;
-	if(options.cardReader == nullptr) {
-		*out_ocg_duel = nullptr;
+static int sanitize_duel_options(OCG_DuelOptions& options) {
+	if(options.cardReader == nullptr)
 		return OCG_DUEL_CREATION_NULL_DATA_READER;
-	}
-	if(options.scriptReader == nullptr) {
-		*out_ocg_duel = nullptr;
+	if(options.scriptReader == nullptr)
 		return OCG_DUEL_CREATION_NULL_SCRIPT_READER;
-	}
 	if(options.logHandler == nullptr) {
 		options.logHandler = [](void* /*payload*/, const char* /*string*/, int /*type*/) {};
 		options.payload3 = nullptr;
@@ -42,6 +185,17 @@ OCGAPI int OCG_CreateDuel(OCG_Duel* out_ocg_duel, const OCG_DuelOptions* options
 	}
 	if(options.seed[0] == 0 && options.seed[1] == 0 && options.seed[2] == 0 && options.seed[3] == 0)
 		return OCG_DUEL_CREATION_NULL_RNG_SEED;
+	return OCG_DUEL_CREATION_SUCCESS;
+}
+
+OCGAPI int OCG_CreateDuel(OCG_Duel* out_ocg_duel, const OCG_DuelOptions* options_ptr) {
+	if(out_ocg_duel == nullptr)
+		return OCG_DUEL_CREATION_NO_OUTPUT;
+	auto options = *options_ptr;
+	if(auto status = sanitize_duel_options(options); status != OCG_DUEL_CREATION_SUCCESS) {
+		*out_ocg_duel = nullptr;
+		return status;
+	}
 	bool valid_lua_lib = true;
 	auto* duelPtr = new (std::nothrow) duel(options, valid_lua_lib);
 	if(duelPtr == nullptr)
@@ -50,10 +204,26 @@ OCGAPI int OCG_CreateDuel(OCG_Duel* out_ocg_duel, const OCG_DuelOptions* options
 		delete duelPtr;
 		return OCG_DUEL_CREATION_INCOMPATIBLE_LUA_API;
 	}
+	journal_begin(duelPtr, options);
 	*out_ocg_duel = static_cast<OCG_Duel>(duelPtr);
 	return OCG_DUEL_CREATION_SUCCESS;
 }
 
+OCGAPI int OCG_DuelReset(OCG_Duel ocg_duel, const OCG_DuelOptions* options_ptr) {
+	if(ocg_duel == nullptr)
+		return OCG_DUEL_CREATION_NOT_CREATED;
+	auto options = *options_ptr;
+	if(auto status = sanitize_duel_options(options); status != OCG_DUEL_CREATION_SUCCESS)
+		return status;
+	bool valid_lua_lib = true;
+	auto* pduel = static_cast<duel*>(ocg_duel);
+	pduel->reset(options, valid_lua_lib);
+	if(!valid_lua_lib)
+		return OCG_DUEL_CREATION_INCOMPATIBLE_LUA_API;
+	journal_begin(pduel, options);
+	return OCG_DUEL_CREATION_SUCCESS;
+}
+
 OCGAPI void OCG_DestroyDuel(OCG_Duel ocg_duel) {
 	if(ocg_duel)
 		delete static_cast<duel*>(ocg_duel);
@@ -65,10 +235,18 @@ OCGAPI void OCG_DuelNewCard(OCG_Duel ocg_duel, const OCG_NewCardInfo* info_ptr)
 	const auto& info = *info_ptr;
 	if(bit::popcnt(info.loc) > 1)
 		return;
+	if(auto* journal = journal_record(pduel, JOURNAL_RECORD::NEW_CARD)) {
+		visit_journal_card_info(info, [journal](auto value) {
+			insert_value<decltype(value)>(*journal, value);
+			return true;
+		});
+	}
+	const journal_scope scope(pduel);
 	auto duelist = info.duelist;
+	const bool lazy_init = game_field.is_flag(DUEL_LAZY_CARD_INIT) && info.loc == LOCATION_DECK;
 	if(duelist == 0) {
 		if(game_field.is_location_useable(info.con, info.loc, info.seq)) {
-			card* pcard = pduel->new_card(info.code);
+			card* pcard = pduel->new_card(info.code, lazy_init);
 			pcard->owner = info.team;
 			game_field.add_card(info.con, pcard, (uint8_t)info.loc, (uint8_t)info.seq);
 			pcard->current.position = info.pos;
@@ -87,7 +265,7 @@ OCGAPI void OCG_DuelNewCard(OCG_Duel ocg_duel, const OCG_NewCardInfo* info_ptr)
 	} else {
 		if(info.team > 1 || !(info.loc & (LOCATION_DECK | LOCATION_EXTRA)))
 			return;
-		card* pcard = pduel->new_card(info.code);
+		card* pcard = pduel->new_card(info.code, lazy_init);
 		auto& player = game_field.player[info.team];
 		if(duelist > player.extra_lists_main.size()) {
 			player.extra_lists_main.resize(duelist);
@@ -108,20 +286,44 @@ OCGAPI void OCG_DuelNewCard(OCG_Duel ocg_duel, const OCG_NewCardInfo* info_ptr)
 
 OCGAPI void OCG_StartDuel(OCG_Duel ocg_duel) {
 	auto* pduel = static_cast<duel*>(ocg_duel);
+	journal_record(pduel, JOURNAL_RECORD::START);
 	pduel->game_field->emplace_process<Processors::Startup>();
 }
 
 OCGAPI int OCG_DuelProcess(OCG_Duel ocg_duel) {
 	auto* pduel = static_cast<duel*>(ocg_duel);
+	// the record stores the number of steps run, as with a budget or a message
+	// handler it can't be inferred from the messages generated, it's filled at the end
+	size_t steps_offset = 0;
+	if(auto* journal = journal_record(pduel, JOURNAL_RECORD::PROCESS)) {
+		steps_offset = journal->size();
+		insert_value<uint32_t>(*journal, 0);
+	}
+	uint32_t steps = 0;
 	pduel->buff.clear();
-	auto flag = OCG_DUEL_STATUS_END;
-	do {
-		flag = pduel->game_field->process();
-		pduel->generate_buffer();
-	} while(pduel->buff.size() == 0 && flag == OCG_DUEL_STATUS_CONTINUE);
+	pduel->lua->reset_budget();
+	const auto flag = [&] {
+		const journal_scope scope(pduel);
+		return process_steps(pduel, steps);
+	}();
+	if(steps_offset != 0)
+		std::memcpy(&pduel->journal[steps_offset], &steps, sizeof(steps));
+	if(!pduel->lua->allocator.limit_reached)
+		pduel->lua->collect_step_budget();
+	if(flag == OCG_DUEL_STATUS_AWAITING && pduel->awaiting_handler)
+		pduel->awaiting_handler(pduel->awaiting_payload, ocg_duel);
 	return flag;
 }
 
+OCGAPI void OCG_DuelSetHandlers(OCG_Duel ocg_duel, const OCG_DuelHandlers* handlers_ptr) {
+	auto* pduel = static_cast<duel*>(ocg_duel);
+	const OCG_DuelHandlers handlers = handlers_ptr ? *handlers_ptr : OCG_DuelHandlers{};
+	pduel->message_handler = handlers.messageHandler;
+	pduel->message_payload = handlers.payload1;
+	pduel->awaiting_handler = handlers.awaitingHandler;
+	pduel->awaiting_payload = handlers.payload2;
+}
+
 OCGAPI void* OCG_DuelGetMessage(OCG_Duel ocg_duel, uint32_t* length) {
 	auto* pduel = static_cast<duel*>(ocg_duel);
 	pduel->generate_buffer();
@@ -132,12 +334,26 @@ OCGAPI void* OCG_DuelGetMessage(OCG_Duel ocg_duel, uint32_t* length) {
 
 OCGAPI void OCG_DuelSetResponse(OCG_Duel ocg_duel, const void* buffer, uint32_t length) {
 	auto* pduel = static_cast<duel*>(ocg_duel);
+	if(auto* journal = journal_record(pduel, JOURNAL_RECORD::RESPONSE)) {
+		insert_value<uint32_t>(*journal, length);
+		if(length)
+			journal->insert(journal->end(), static_cast<const uint8_t*>(buffer), static_cast<const uint8_t*>(buffer) + length);
+	}
 	pduel->set_response(buffer, length);
 }
 
 OCGAPI int OCG_LoadScript(OCG_Duel ocg_duel, const char* buffer, uint32_t length, const char* name) {
 	auto* pduel = static_cast<duel*>(ocg_duel);
-	return pduel->lua->load_script(buffer, length, name);
+	if(buffer == nullptr)
+		return 0;
+	const auto result_offset = journal_load_script(pduel, buffer, length, name);
+	const auto loaded = [&] {
+		const journal_scope scope(pduel);
+		return pduel->lua->load_script(buffer, length, name);
+	}();
+	if(result_offset != 0)
+		pduel->journal[result_offset] = loaded;
+	return loaded;
 }
 
 OCGAPI uint32_t OCG_DuelQueryCount(OCG_Duel ocg_duel, uint8_t team, uint32_t loc) {
@@ -168,23 +384,19 @@ OCGAPI uint32_t OCG_DuelQueryCount(OCG_Duel ocg_duel, uint8_t team, uint32_t loc
 	}
 	return count;
 }
-template<typename T>
-void insert_value_int(std::vector<uint8_t>& vec, T val) {
-	const auto vec_size = vec.size();
-	const auto val_size = sizeof(T);
-	vec.resize(vec_size + val_size);
-	std::memcpy(&vec[vec_size], &val, val_size);
-}
-template<typename T, typename T2>
-ForceInline void insert_value(std::vector<uint8_t>& vec, T2 val) {
-	insert_value_int<T>(vec, static_cast<T>(val));
-}
-
 OCGAPI void* OCG_DuelQuery(OCG_Duel ocg_duel, uint32_t* length, const OCG_QueryInfo* info_ptr) {
 	const auto& info = *info_ptr;
 	auto* pduel = static_cast<duel*>(ocg_duel);
 	if(bit::popcnt(info.loc & ~LOCATION_OVERLAY) != 1)
 		return 0;
+	// querying a card in the deck can run its deferred initial_effect
+	if(info.loc == LOCATION_DECK && pduel->game_field->is_flag(DUEL_LAZY_CARD_INIT)) {
+		if(auto* journal = journal_record(pduel, JOURNAL_RECORD::QUERY)) {
+			insert_value<uint8_t>(*journal, info.con);
+			insert_value<uint32_t>(*journal, info.seq);
+		}
+	}
+	const journal_scope scope(pduel);
 	pduel->query_buffer.clear();
 	card* pcard = nullptr;
 	if(info.loc & LOCATION_OVERLAY) {
@@ -194,6 +406,8 @@ OCGAPI void* OCG_DuelQuery(OCG_Duel ocg_duel, uint32_t* length, const OCG_QueryI
 		}
 	} else {
 		pcard = pduel->game_field->get_field_card(info.con, info.loc, info.seq);
+		if(pcard && pcard->pending_initial_effect)
+			pduel->lua->run_initial_effect(pcard);
 	}
 	if(pcard == nullptr) {
 		if(length)
@@ -238,8 +452,13 @@ OCGAPI void* OCG_DuelQueryLocation(OCG_Duel ocg_duel, uint32_t* length, const OC
 				populate(player.list_remove);
 			else if(info.loc == LOCATION_EXTRA)
 				populate(player.list_extra);
-			else if(info.loc == LOCATION_DECK)
+			else if(info.loc == LOCATION_DECK) {
+				if(auto* journal = journal_record(pduel, JOURNAL_RECORD::QUERY_LOCATION))
+					insert_value<uint8_t>(*journal, info.con);
+				const journal_scope scope(pduel);
+				pduel->game_field->init_deck_cards(info.con);
 				populate(player.list_main);
+			}
 		}
 		std::vector<uint8_t> tmp_vector;
 		insert_value<uint32_t>(tmp_vector, buffer.size());
@@ -302,3 +521,166 @@ OCGAPI void* OCG_DuelQueryField(OCG_Duel ocg_duel, uint32_t* length) {
 		*length = static_cast<uint32_t>(query.size());
 	return query.data();
 }
+
+OCGAPI void OCG_DuelGetStats(OCG_Duel ocg_duel, OCG_DuelStats* stats) {
+	if(!stats)
+		return;
+	auto* pduel = static_cast<duel*>(ocg_duel);
+	const auto& allocator = pduel->lua->allocator;
+	stats->luaMemoryCurrent = allocator.current;
+	stats->luaMemoryPeak = allocator.peak;
+	stats->luaMemoryLimit = allocator.limit;
+	stats->gcCollections = pduel->lua->gc_collections;
+	stats->gcTimeNs = pduel->lua->gc_time;
+	stats->groupsReclaimed = pduel->groups_reclaimed;
+	const auto& core = pduel->game_field->core;
+	stats->adjustPasses = core.adjust_passes;
+	stats->adjustTrapMonsterSkipped = core.adjust_trap_monster_skipped;
+	stats->adjustPositionSkipped = core.adjust_position_skipped;
+	stats->eventConditionChecksSkipped = core.event_condition_checks_skipped;
+	stats->eventsRaised = core.events_raised;
+	stats->eventGroupsCreated = core.event_groups_created;
+}
+
+OCGAPI void* OCG_DuelSerialize(OCG_Duel ocg_duel, uint32_t* length) {
+	auto* pduel = static_cast<duel*>(ocg_duel);
+	if(length)
+		*length = static_cast<uint32_t>(pduel->journal.size());
+	if(pduel->journal.empty())
+		return nullptr;
+	return pduel->journal.data();
+}
+
+static bool replay_journal_record(OCG_Duel ocg_duel, journal_reader& reader) {
+	JOURNAL_RECORD type;
+	if(!reader.read(type))
+		return false;
+	switch(type) {
+	case JOURNAL_RECORD::NEW_CARD: {
+		OCG_NewCardInfo info;
+		if(!visit_journal_card_info(info, [&reader](auto& value) { return reader.read(value); }))
+			return false;
+		OCG_DuelNewCard(ocg_duel, &info);
+		return true;
+	}
+	case JOURNAL_RECORD::START:
+		OCG_StartDuel(ocg_duel);
+		return true;
+	case JOURNAL_RECORD::PROCESS: {
+		// the same steps are run regardless of the budget and of the handlers
+		uint32_t steps;
+		if(!reader.read(steps))
+			return false;
+		auto* pduel = static_cast<duel*>(ocg_duel);
+		if(auto* journal = journal_record(pduel, JOURNAL_RECORD::PROCESS))
+			insert_value<uint32_t>(*journal, steps);
+		const journal_scope scope(pduel);
+		pduel->buff.clear();
+		for(uint32_t i = 0; i < steps; ++i) {
+			pduel->game_field->process();
+			pduel->generate_buffer();
+		}
+		if(!pduel->lua->allocator.limit_reached)
+			pduel->lua->collect_step_budget();
+		return true;
+	}
+	case JOURNAL_RECORD::RESPONSE: {
+		uint32_t length;
+		const uint8_t* buffer;
+		if(!reader.read(length) || (buffer = reader.read_bytes(length)) == nullptr)
+			return false;
+		OCG_DuelSetResponse(ocg_duel, buffer, length);
+		return true;
+	}
+	case JOURNAL_RECORD::LOAD_SCRIPT: {
+		// the replay fails if the script doesn't load the same way it did when recorded,
+		// e.g. if the script reader of the restoring host can't find it
+		uint8_t has_name, loaded;
+		uint32_t length;
+		const uint8_t* buffer;
+		if(!reader.read(has_name) || !reader.read(length) || (buffer = reader.read_bytes(length)) == nullptr
+		   || !reader.read(loaded))
+			return false;
+		if(!has_name)
+			return (OCG_LoadScript(ocg_duel, reinterpret_cast<const char*>(buffer), length, nullptr) != 0) == (loaded != 0);
+		auto* pduel = static_cast<duel*>(ocg_duel);
+		const std::string name(reinterpret_cast<const char*>(buffer), length);
+		const auto result_offset = journal_load_script(pduel, nullptr, 0, name.data());
+		const auto res = [&] {
+			const journal_scope scope(pduel);
+			return pduel->read_script(name.data()) != 0;
+		}();
+		if(result_offset != 0)
+			pduel->journal[result_offset] = res;
+		return res == (loaded != 0);
+	}
+	case JOURNAL_RECORD::QUERY: {
+		OCG_QueryInfo info{};
+		info.loc = LOCATION_DECK;
+		if(!reader.read(info.con) || !reader.read(info.seq))
+			return false;
+		OCG_DuelQuery(ocg_duel, nullptr, &info);
+		return true;
+	}
+	case JOURNAL_RECORD::QUERY_LOCATION: {
+		OCG_QueryInfo info{};
+		info.loc = LOCATION_DECK;
+		if(!reader.read(info.con))
+			return false;
+		OCG_DuelQueryLocation(ocg_duel, nullptr, &info);
+		return true;
+	}
+	}
+	return false;
+}
+
+OCGAPI int OCG_DuelDeserialize(OCG_Duel* out_ocg_duel, const OCG_DuelOptions* options_ptr, const void* buffer, uint32_t length) {
+	if(out_ocg_duel == nullptr)
+		return OCG_DUEL_CREATION_NO_OUTPUT;
+	*out_ocg_duel = nullptr;
+	auto options = *options_ptr;
+	journal_reader reader(buffer, length);
+	uint32_t magic;
+	uint16_t version;
+	if(buffer == nullptr || !reader.read(magic) || magic != journal_magic || !reader.read(version) || version != journal_version
+	   || !visit_journal_options(options, [&reader](auto& value) { return reader.read(value); }))
+		return OCG_DUEL_CREATION_INVALID_STATE;
+	if(auto status = sanitize_duel_options(options); status != OCG_DUEL_CREATION_SUCCESS)
+		return status;
+	// the messages logged while replaying were already delivered when the duel originally ran
+	const auto log_handler = options.logHandler;
+	const auto log_payload = options.payload3;
+	options.logHandler = [](void* /*payload*/, const char* /*string*/, int /*type*/) {};
+	OCG_Duel ocg_duel = nullptr;
+	if(auto status = OCG_CreateDuel(&ocg_duel, &options); status != OCG_DUEL_CREATION_SUCCESS)
+		return status;
+	// with DUEL_COMPACT_MESSAGES each message is encoded against the previous one of its type,
+	// the restoring host starts decoding from the buffer left by the replay, so the replay
+	// generates plain messages and only those of the last call are encoded, starting from
+	// an empty history like the new decoder of that host
+	auto* pduel = static_cast<duel*>(ocg_duel);
+	const auto compact_messages = std::exchange(pduel->compact_messages, false);
+	while(!reader.done()) {
+		if(!replay_journal_record(ocg_duel, reader)) {
+			OCG_DestroyDuel(ocg_duel);
+			return OCG_DUEL_CREATION_INVALID_STATE;
+		}
+	}
+	if(compact_messages) {
+		pduel->compact_messages = true;
+		const auto plain = std::move(pduel->buff);
+		pduel->buff.clear();
+		std::vector<uint8_t> message;
+		for(size_t pos = 0; plain.size() - pos >= sizeof(uint32_t);) {
+			uint32_t size;
+			std::memcpy(&size, &plain[pos], sizeof(size));
+			pos += sizeof(size);
+			message.assign(plain.begin() + pos, plain.begin() + pos + size);
+			pduel->write_compact_message(message);
+			pos += size;
+		}
+	}
+	pduel->set_log_handler(log_handler, log_payload);
+	*out_ocg_duel = ocg_duel;
+	return OCG_DUEL_CREATION_SUCCESS;
+}
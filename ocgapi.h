@@ -31,11 +31,15 @@ OCGAPI void OCG_GetVersion(int* major, int* minor);
 /*** DUEL CREATION AND DESTRUCTION ***/
 OCGAPI int OCG_CreateDuel(OCG_Duel* out_ocg_duel, const OCG_DuelOptions* options_ptr);
 OCGAPI void OCG_DestroyDuel(OCG_Duel ocg_duel);
+OCGAPI int OCG_DuelReset(OCG_Duel ocg_duel, const OCG_DuelOptions* options_ptr);
+OCGAPI void* OCG_DuelSerialize(OCG_Duel ocg_duel, uint32_t* length);
+OCGAPI int OCG_DuelDeserialize(OCG_Duel* out_ocg_duel, const OCG_DuelOptions* options_ptr, const void* buffer, uint32_t length);
 OCGAPI void OCG_DuelNewCard(OCG_Duel ocg_duel, const OCG_NewCardInfo* info_ptr);
 OCGAPI void OCG_StartDuel(OCG_Duel ocg_duel);
 
 /*** DUEL PROCESSING AND QUERYING ***/
 OCGAPI int OCG_DuelProcess(OCG_Duel ocg_duel);
+OCGAPI void OCG_DuelSetHandlers(OCG_Duel ocg_duel, const OCG_DuelHandlers* handlers_ptr);
 OCGAPI void* OCG_DuelGetMessage(OCG_Duel ocg_duel, uint32_t* length);
 OCGAPI void OCG_DuelSetResponse(OCG_Duel ocg_duel, const void* buffer, uint32_t length);
 OCGAPI int OCG_LoadScript(OCG_Duel ocg_duel, const char* buffer, uint32_t length, const char* name);
@@ -45,4 +49,6 @@ OCGAPI void* OCG_DuelQuery(OCG_Duel ocg_duel, uint32_t* length, const OCG_QueryI
 OCGAPI void* OCG_DuelQueryLocation(OCG_Duel ocg_duel, uint32_t* length, const OCG_QueryInfo* info_ptr);
 OCGAPI void* OCG_DuelQueryField(OCG_Duel ocg_duel, uint32_t* length);
 
+OCGAPI void OCG_DuelGetStats(OCG_Duel ocg_duel, OCG_DuelStats* stats);
+
 #endif /* OCGAPI_H */
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2026, Edoardo Lolletti (edo9300) <edoardo762@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#ifndef OCGAPI_MESSAGES_H
+#define OCGAPI_MESSAGES_H
+
+#include <array>
+#include <cstddef> //size_t
+#include <cstdint>
+#include <cstring> //std::memcpy
+#include <tuple>
+#include <type_traits>
+#include <utility> //std::index_sequence
+#include <vector>
+
+/*
+	Layout of the messages with a fixed size, as the list of the fields following the message type.
+	The core writes those messages only through duel::write_message, so the layout can't drift from
+	the one declared here, and hosts can read them in place from the buffer of OCG_DuelGetMessage
+	(or from the OCG_MessageHandler) with MessageView, without hand written parsers.
+	Messages not listed here have a variable layout and still have to be parsed manually.
+*/
+namespace Messages {
+
+template<typename... T>
+struct Fields {
+	using types = std::tuple<T...>;
+	static constexpr size_t count = sizeof...(T);
+	static constexpr size_t size = (sizeof(T) + ... + 0);
+	// offset of the field at index, relative to the start of the message body
+	template<size_t index>
+	static constexpr size_t offset() {
+		constexpr size_t sizes[] = { sizeof(T)..., 0 };
+		size_t res = 0;
+		for(size_t i = 0; i < index; ++i)
+			res += sizes[i];
+		return res;
+	}
+};
+
+// types of the messages with a schema, same values as the MSG_ constants of the core
+enum Type : uint8_t {
+	HINT = 2,
+	WIN = 5,
+	SHUFFLE_DECK = 32,
+	REVERSE_DECK = 37,
+	NEW_PHASE = 41,
+	FIELD_DISABLED = 56,
+	SUMMONED = 61,
+	SPSUMMONED = 63,
+	FLIPSUMMONED = 65,
+	CHAIN_SOLVING = 72,
+	CHAIN_SOLVED = 73,
+	CHAIN_END = 74,
+	CHAIN_NEGATED = 75,
+	CHAIN_DISABLED = 76,
+	DAMAGE = 91,
+	RECOVER = 92,
+	LPUPDATE = 94,
+	PAY_LPCOST = 100,
+	ATTACK_DISABLED = 112,
+	DAMAGE_STEP_START = 113,
+	DAMAGE_STEP_END = 114,
+};
+
+template<uint8_t message>
+struct Schema;
+
+// type, player, data
+template<> struct Schema<HINT> : Fields<uint8_t, uint8_t, uint64_t> {};
+// player, reason
+template<> struct Schema<WIN> : Fields<uint8_t, uint8_t> {};
+// phase
+template<> struct Schema<NEW_PHASE> : Fields<uint16_t> {};
+// player, amount, reason
+template<> struct Schema<DAMAGE> : Fields<uint8_t, uint32_t, uint32_t> {};
+// player, amount
+template<> struct Schema<RECOVER> : Fields<uint8_t, uint32_t> {};
+// player, lp
+template<> struct Schema<LPUPDATE> : Fields<uint8_t, uint32_t> {};
+// player, cost
+template<> struct Schema<PAY_LPCOST> : Fields<uint8_t, uint32_t> {};
+// chain count
+template<> struct Schema<CHAIN_SOLVING> : Fields<uint8_t> {};
+template<> struct Schema<CHAIN_SOLVED> : Fields<uint8_t> {};
+template<> struct Schema<CHAIN_NEGATED> : Fields<uint8_t> {};
+template<> struct Schema<CHAIN_DISABLED> : Fields<uint8_t> {};
+// player
+template<> struct Schema<SHUFFLE_DECK> : Fields<uint8_t> {};
+// disabled zones
+template<> struct Schema<FIELD_DISABLED> : Fields<uint32_t> {};
+template<> struct Schema<CHAIN_END> : Fields<> {};
+template<> struct Schema<ATTACK_DISABLED> : Fields<> {};
+template<> struct Schema<DAMAGE_STEP_START> : Fields<> {};
+template<> struct Schema<DAMAGE_STEP_END> : Fields<> {};
+template<> struct Schema<REVERSE_DECK> : Fields<> {};
+template<> struct Schema<SUMMONED> : Fields<> {};
+template<> struct Schema<SPSUMMONED> : Fields<> {};
+template<> struct Schema<FLIPSUMMONED> : Fields<> {};
+
+template<uint8_t message>
+using field_t = typename Schema<message>::types;
+
+// a single message, pointing in the buffer it was read from
+class MessageView {
+	const uint8_t* ptr;
+	uint32_t len;
+public:
+	MessageView(const void* data, uint32_t length) : ptr(static_cast<const uint8_t*>(data)), len(length) {}
+	uint8_t type() const {
+		return len != 0 ? ptr[0] : 0;
+	}
+	const uint8_t* data() const {
+		return ptr;
+	}
+	uint32_t length() const {
+		return len;
+	}
+	// whether this is a message of the given type, with the size its schema declares
+	template<uint8_t message>
+	bool is() const {
+		return len == 1 + Schema<message>::size && ptr[0] == message;
+	}
+	// the field at index of a message checked with is<message>()
+	template<uint8_t message, size_t index>
+	std::tuple_element_t<index, field_t<message>> get() const {
+		std::tuple_element_t<index, field_t<message>> value;
+		std::memcpy(&value, ptr + 1 + Schema<message>::template offset<index>(), sizeof(value));
+		return value;
+	}
+};
+
+// iterates the length prefixed messages of a buffer returned by OCG_DuelGetMessage
+class MessageBuffer {
+	const uint8_t* ptr;
+	const uint8_t* end_ptr;
+public:
+	MessageBuffer(const void* buffer, uint32_t length) :
+		ptr(static_cast<const uint8_t*>(buffer)), end_ptr(ptr + length) {}
+	class iterator {
+		const uint8_t* ptr;
+		const uint8_t* end_ptr;
+		uint32_t message_length() const {
+			uint32_t len;
+			std::memcpy(&len, ptr, sizeof(len));
+			return len;
+		}
+	public:
+		iterator(const uint8_t* ptr, const uint8_t* end_ptr) : ptr(ptr), end_ptr(end_ptr) {
+			// a truncated message ends the iteration
+			if(static_cast<size_t>(end_ptr - ptr) < sizeof(uint32_t) || end_ptr - ptr - sizeof(uint32_t) < message_length())
+				this->ptr = end_ptr;
+		}
+		MessageView operator*() const {
+			return { ptr + sizeof(uint32_t), message_length() };
+		}
+		iterator& operator++() {
+			*this = iterator(ptr + sizeof(uint32_t) + message_length(), end_ptr);
+			return *this;
+		}
+		bool operator==(const iterator& other) const {
+			return ptr == other.ptr;
+		}
+		bool operator!=(const iterator& other) const {
+			return ptr != other.ptr;
+		}
+	};
+	iterator begin() const {
+		return { ptr, end_ptr };
+	}
+	iterator end() const {
+		return { end_ptr, end_ptr };
+	}
+};
+
+/*
+	Decodes the buffers of a duel created with DUEL_COMPACT_MESSAGES, each message is decoded
+	against the previous one of the same type, so a decoder has to be fed all the buffers
+	of the duel, in order, from its start. Buffers can be fed as they are received.
+*/
+class CompactStreamDecoder {
+	std::array<std::vector<uint8_t>, 256> previous;
+	static bool read_varint(const uint8_t*& ptr, const uint8_t* end, uint32_t& value) {
+		value = 0;
+		for(int shift = 0; shift < 35; shift += 7) {
+			if(ptr == end)
+				return false;
+			const uint8_t byte = *ptr++;
+			value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+			if(!(byte & 0x80))
+				return true;
+		}
+		return false;
+	}
+public:
+	// forgets the previous messages, to decode the stream of a duel that was reset with OCG_DuelReset
+	// or restored with OCG_DuelDeserialize
+	void reset() {
+		for(auto& message : previous)
+			message.clear();
+	}
+	// calls callback with a MessageView of every message in the buffer, the view is only valid
+	// during the call, returns false if the buffer is malformed
+	template<typename F>
+	bool decode(const void* buffer, uint32_t length, F&& callback) {
+		auto ptr = static_cast<const uint8_t*>(buffer);
+		const auto end = ptr + length;
+		std::vector<uint8_t> message;
+		while(ptr != end) {
+			uint32_t size;
+			if(!read_varint(ptr, end, size) || size == 0 || ptr == end)
+				return false;
+			const uint8_t type = *ptr++;
+			const auto& reference = previous[type];
+			// every byte after the type is either copied from the previous message or read from the buffer
+			if(size - 1 > reference.size() + static_cast<size_t>(end - ptr))
+				return false;
+			message.resize(size);
+			message[0] = type;
+			size_t i = 1;
+			while(i < size) {
+				uint32_t copy, literal;
+				if(!read_varint(ptr, end, copy) || !read_varint(ptr, end, literal) || (copy == 0 && literal == 0)
+				   || copy > size - i || (copy != 0 && i + copy > reference.size()) || literal > size - i - copy
+				   || literal > static_cast<size_t>(end - ptr))
+					return false;
+				std::memcpy(message.data() + i, reference.data() + i, copy);
+				i += copy;
+				std::memcpy(message.data() + i, ptr, literal);
+				i += literal;
+				ptr += literal;
+			}
+			previous[type] = message;
+			callback(MessageView(previous[type].data(), size));
+		}
+		return true;
+	}
+};
+
+template<uint8_t message, typename Message, typename... Args, size_t... index>
+inline void write_fields(Message& pmessage, std::index_sequence<index...>, Args... args) {
+	(pmessage.template write<std::tuple_element_t<index, field_t<message>>>(args), ...);
+}
+
+}
+
+#endif /* OCGAPI_MESSAGES_H */
@@ -8,7 +8,7 @@
 #include <stdint.h>
 
 #define OCG_VERSION_MAJOR 11
-#define OCG_VERSION_MINOR 0
+#define OCG_VERSION_MINOR 1
 
 typedef enum OCG_LogTypes {
 	OCG_LOG_TYPE_ERROR,
@@ -24,13 +24,15 @@ typedef enum OCG_DuelCreationStatus {
 	OCG_DUEL_CREATION_NULL_DATA_READER,
 	OCG_DUEL_CREATION_NULL_SCRIPT_READER,
 	OCG_DUEL_CREATION_INCOMPATIBLE_LUA_API,
-	OCG_DUEL_CREATION_NULL_RNG_SEED
+	OCG_DUEL_CREATION_NULL_RNG_SEED,
+	OCG_DUEL_CREATION_INVALID_STATE
 }OCG_DuelCreationStatus;
 
 typedef enum OCG_DuelStatus {
 	OCG_DUEL_STATUS_END,
 	OCG_DUEL_STATUS_AWAITING,
-	OCG_DUEL_STATUS_CONTINUE
+	OCG_DUEL_STATUS_CONTINUE,
+	OCG_DUEL_STATUS_YIELDED
 }OCG_DuelStatus;
 
 typedef void* OCG_Duel;
@@ -66,6 +68,31 @@ typedef void (*OCG_DataReader)(void* payload, uint32_t code, OCG_CardData* data)
 typedef void (*OCG_DataReaderDone)(void* payload, OCG_CardData* data);
 typedef int (*OCG_ScriptReader)(void* payload, OCG_Duel duel, const char* name);
 typedef void (*OCG_LogHandler)(void* payload, const char* string, int type);
+typedef void (*OCG_MessageHandler)(void* payload, const void* message, uint32_t length);
+typedef void (*OCG_AwaitingHandler)(void* payload, OCG_Duel duel);
+
+typedef enum OCG_GCMode {
+	OCG_GC_MODE_INCREMENTAL,
+	OCG_GC_MODE_GENERATIONAL
+}OCG_GCMode;
+
+typedef struct OCG_GCOptions {
+	uint8_t mode; /* OCG_GCMode */
+	/* any of the following left to 0 keeps lua's default */
+	uint16_t pause; /* incremental mode, in percent */
+	uint16_t stepMultiplier; /* incremental mode, in percent */
+	uint8_t stepSize; /* incremental mode, log2 of the size in bytes */
+	uint16_t minorMultiplier; /* generational mode, in percent */
+	uint16_t majorMultiplier; /* generational mode, in percent */
+	uint32_t groupThreshold; /* groups created before forcing a collection step, 0 for 2048 */
+	uint32_t stepBudget; /* collection steps performed at the end of each OCG_DuelProcess call */
+}OCG_GCOptions;
+
+typedef struct OCG_ProcessBudget {
+	/* work done by each OCG_DuelProcess call before it yields, 0 for no limit */
+	uint32_t steps; /* processor steps */
+	uint32_t luaInstructions; /* lua instructions, in thousands */
+}OCG_ProcessBudget;
 
 typedef struct OCG_DuelOptions {
 	uint64_t seed[4];
@@ -84,8 +111,33 @@ typedef struct OCG_DuelOptions {
 	void* payload5;/* get cardData */
 	//////zdiy/////
 	uint8_t enableUnsafeLibraries;
+	uint64_t luaMemoryLimit; /* in bytes, 0 for no limit */
+	OCG_GCOptions gc;
+	OCG_ProcessBudget budget;
 }OCG_DuelOptions;
 
+typedef struct OCG_DuelHandlers {
+	OCG_MessageHandler messageHandler;
+	void* payload1; /* relayed to messageHandler */
+	OCG_AwaitingHandler awaitingHandler;
+	void* payload2; /* relayed to awaitingHandler */
+}OCG_DuelHandlers;
+
+typedef struct OCG_DuelStats {
+	uint64_t luaMemoryCurrent;
+	uint64_t luaMemoryPeak;
+	uint64_t luaMemoryLimit;
+	uint64_t gcCollections;
+	uint64_t gcTimeNs;
+	uint64_t groupsReclaimed;
+	uint64_t adjustPasses;
+	uint64_t adjustTrapMonsterSkipped;
+	uint64_t adjustPositionSkipped;
+	uint64_t eventConditionChecksSkipped;
+	uint64_t eventsRaised;
+	uint64_t eventGroupsCreated;
+}OCG_DuelStats;
+
 typedef struct OCG_NewCardInfo {
 	uint8_t team; /* either 0 or 1 */
 	uint8_t duelist; /* index of original owner */
@@ -33,8 +33,7 @@ int32_t field::negate_chain(uint8_t chaincount) {
 			effect_handler->set_status(STATUS_LEAVE_CONFIRMED, TRUE);
 			effect_handler->set_status(STATUS_ACTIVATE_DISABLED, TRUE);
 		}
-		auto message = pduel->new_message(MSG_CHAIN_NEGATED);
-		message->write<uint8_t>(chaincount);
+		pduel->write_message<MSG_CHAIN_NEGATED>(chaincount);
 		if(!is_flag(DUEL_RETURN_TO_DECK_TRIGGERS) &&
 		   (pchain.triggering_location == LOCATION_DECK
 			|| (pchain.triggering_location == LOCATION_EXTRA && (pchain.triggering_position & POS_FACEDOWN))))
@@ -55,8 +54,7 @@ int32_t field::disable_chain(uint8_t chaincount) {
 		core.current_chain[chaincount - 1].flag |= CHAIN_DISABLE_EFFECT;
 		core.current_chain[chaincount - 1].disable_reason = core.reason_effect;
 		core.current_chain[chaincount - 1].disable_player = core.reason_player;
-		auto message = pduel->new_message(MSG_CHAIN_DISABLED);
-		message->write<uint8_t>(chaincount);
+		pduel->write_message<MSG_CHAIN_DISABLED>(chaincount);
 		if(!is_flag(DUEL_RETURN_TO_DECK_TRIGGERS) &&
 		   (pchain.triggering_location == LOCATION_DECK
 		   || (pchain.triggering_location == LOCATION_EXTRA && (pchain.triggering_position & POS_FACEDOWN))))
@@ -535,9 +533,11 @@ bool field::process(Processors::Draw& arg) {
 				raise_single_event(pcard, nullptr, EVENT_MOVE, reason_effect, reason, reason_player, playerid, 0);
 			}
 			process_single_event();
-			raise_event(drawn_set, EVENT_DRAW, reason_effect, reason, reason_player, playerid, drawn);
-			raise_event(drawn_set, EVENT_TO_HAND, reason_effect, reason, reason_player, playerid, drawn);
-			raise_event(drawn_set, EVENT_MOVE, reason_effect, reason, reason_player, playerid, drawn);
+			auto drawn_group = pduel->new_group(drawn_set);
+			drawn_group->is_readonly = true;
+			raise_event(drawn_group, EVENT_DRAW, reason_effect, reason, reason_player, playerid, drawn);
+			raise_event(drawn_group, EVENT_TO_HAND, reason_effect, reason, reason_player, playerid, drawn);
+			raise_event(drawn_group, EVENT_MOVE, reason_effect, reason, reason_player, playerid, drawn);
 			process_instant_event();
 		}
 		return FALSE;
@@ -630,11 +630,8 @@ bool field::process(Processors::Damage& arg) {
 		else
 		//////kdiy/////////
 		player[playerid].lp -= amount;
-		auto message = pduel->new_message(MSG_DAMAGE);
-		message->write<uint8_t>(playerid);
-		message->write<uint32_t>(amount);
 		//////kdiy/////////
-		message->write<uint32_t>(reason);
+		pduel->write_message<MSG_DAMAGE>(playerid, amount, reason);
 		//////kdiy/////////
 		raise_event(reason_card, EVENT_DAMAGE, reason_effect, reason, reason_player, playerid, amount);
 		//////kdiy/////////
@@ -645,7 +642,7 @@ bool field::process(Processors::Damage& arg) {
 		//////kdiy/////////
 		if(reason == REASON_BATTLE && reason_card) {
 			if((player[playerid].lp <= 0) && (core.attack_target == nullptr) && reason_card->is_affected_by_effect(EFFECT_MATCH_KILL) && !is_player_affected_by_effect(playerid, EFFECT_CANNOT_LOSE_LP)) {
-				message = pduel->new_message(MSG_MATCH_KILL);
+				auto message = pduel->new_message(MSG_MATCH_KILL);
 				message->write<uint32_t>(reason_card->data.code);
 			}
 			raise_single_event(reason_card, nullptr, EVENT_BATTLE_DAMAGE, nullptr, 0, reason_player, playerid, amount);
@@ -735,9 +732,7 @@ bool field::process(Processors::Recover& arg) {
 		else
 		//////kdiy/////////
 		player[playerid].lp += amount;
-		auto message = pduel->new_message(MSG_RECOVER);
-		message->write<uint8_t>(playerid);
-		message->write<uint32_t>(amount);
+		pduel->write_message<MSG_RECOVER>(playerid, amount);
 		raise_event(nullptr, EVENT_RECOVER, reason_effect, reason, reason_player, playerid, amount);
 		process_instant_event();
 		return FALSE;
@@ -819,9 +814,7 @@ bool field::process(Processors::PayLPCost& arg) {
 			else
 			//////kdiy/////////
 			player[playerid].lp -= cost;
-			auto message = pduel->new_message(MSG_PAY_LPCOST);
-			message->write<uint8_t>(playerid);
-			message->write<uint32_t>(cost);
+			pduel->write_message<MSG_PAY_LPCOST>(playerid, cost);
 			raise_event(nullptr, EVENT_PAY_LPCOST, core.reason_effect, 0, playerid, playerid, cost);
 			process_instant_event();
 			return TRUE;
@@ -1003,10 +996,7 @@ bool field::process(Processors::RemoveOverlay& arg) {
 		get_overlay_group(rplayer, self, oppo, &cset, pgroup);
 		for(auto& xcard : cset)
 			core.select_cards.push_back(xcard);
-		auto message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_SELECTMSG);
-		message->write<uint8_t>(rplayer);
-		message->write<uint64_t>(519);
+		pduel->write_message<MSG_HINT>(HINT_SELECTMSG, rplayer, 519);
 		emplace_process<Processors::SelectCard>(rplayer, cancelable, min, max);
 		return FALSE;
 	}
@@ -1187,10 +1177,7 @@ bool field::process(Processors::GetControl& arg) {
 			core.select_cards.clear();
 			for(auto& pcard : targets->container)
 				core.select_cards.push_back(pcard);
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_SELECTMSG);
-			message->write<uint8_t>(playerid);
-			message->write<uint64_t>(502);
+			pduel->write_message<MSG_HINT>(HINT_SELECTMSG, playerid, 502);
 			uint16_t ct = static_cast<uint16_t>(targets->container.size() - fcount);
 			emplace_process<Processors::SelectCard>(playerid, false, ct, ct);
 		} else
@@ -1419,10 +1406,7 @@ bool field::process(Processors::SwapControl& arg) {
 		} else
 		///////////kdiy//////////
 		flag = (flag & ~(1 << s1) & 0xff) | ~0x1f;			
-		auto message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_SELECTMSG);
-		message->write<uint8_t>(p1);
-		message->write<uint64_t>(pcard2->data.code);
+		pduel->write_message<MSG_HINT>(HINT_SELECTMSG, p1, pcard2->data.code);
 		emplace_process<Processors::SelectPlace>(p1, flag, 1);
 		return FALSE;
 	}
@@ -1446,10 +1430,7 @@ bool field::process(Processors::SwapControl& arg) {
 		} else
 		///////////kdiy//////////
 		flag = (flag & ~(1 << s2) & 0xff) | ~0x1f;
-		auto message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_SELECTMSG);
-		message->write<uint8_t>(p2);
-		message->write<uint64_t>(pcard1->data.code);
+		pduel->write_message<MSG_HINT>(HINT_SELECTMSG, p2, pcard1->data.code);
 		emplace_process<Processors::SelectPlace>(p2, flag, 1);
 		return FALSE;
 	}
@@ -1550,10 +1531,7 @@ bool field::process(Processors::ControlAdjust& arg) {
 					core.select_cards.clear();
 					for(auto& pcard : core.control_adjust_set[0])
 						core.select_cards.push_back(pcard);
-					auto message = pduel->new_message(MSG_HINT);
-					message->write<uint8_t>(HINT_SELECTMSG);
-					message->write<uint8_t>(infos.turn_player);
-					message->write<uint64_t>(502);
+					pduel->write_message<MSG_HINT>(HINT_SELECTMSG, infos.turn_player, 502);
 					emplace_process<Processors::SelectCard>(1, false, count, count);
 				}
 			} else
@@ -1569,10 +1547,7 @@ bool field::process(Processors::ControlAdjust& arg) {
 					core.select_cards.clear();
 					for(auto& pcard : core.control_adjust_set[1])
 						core.select_cards.push_back(pcard);
-					auto message = pduel->new_message(MSG_HINT);
-					message->write<uint8_t>(HINT_SELECTMSG);
-					message->write<uint8_t>(infos.turn_player);
-					message->write<uint64_t>(502);
+					pduel->write_message<MSG_HINT>(HINT_SELECTMSG, infos.turn_player, 502);
 					emplace_process<Processors::SelectCard>(0, false, count, count);
 				}
 			} else
@@ -1705,8 +1680,10 @@ bool field::process(Processors::ControlAdjust& arg) {
 			raise_single_event(pcard, nullptr, EVENT_MOVE, nullptr, REASON_RULE, 0, pcard->current.controler, 0);
 		}
 		if(core.control_adjust_set[0].size()) {
-			raise_event(core.control_adjust_set[0], EVENT_CONTROL_CHANGED, nullptr, 0, 0, 0, 0);
-			raise_event(core.control_adjust_set[0], EVENT_MOVE, nullptr, 0, 0, 0, 0);
+			auto ng = pduel->new_group(core.control_adjust_set[0]);
+			ng->is_readonly = true;
+			raise_event(ng, EVENT_CONTROL_CHANGED, nullptr, 0, 0, 0, 0);
+			raise_event(ng, EVENT_MOVE, nullptr, 0, 0, 0, 0);
 		}
 		process_single_event();
 		process_instant_event();
@@ -1768,10 +1745,7 @@ bool field::process(Processors::SelfDestroyUnique& arg) {
 				return_cards.clear();
 				return_cards.list.push_back(core.select_cards.front());
 			} else {
-				auto message = pduel->new_message(MSG_HINT);
-				message->write<uint8_t>(HINT_SELECTMSG);
-				message->write<uint8_t>(playerid);
-				message->write<uint64_t>(534);
+				pduel->write_message<MSG_HINT>(HINT_SELECTMSG, playerid, 534);
 				emplace_process<Processors::SelectCard>(playerid, false, 1, 1);
 			}
 			return FALSE;
@@ -1884,10 +1858,7 @@ bool field::process(Processors::TrapMonsterAdjust& arg) {
 			core.select_cards.clear();
 			for(auto& pcard : core.trap_monster_adjust_set[check_player])
 				core.select_cards.push_back(pcard);
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_SELECTMSG);
-			message->write<uint8_t>(check_player);
-			message->write<uint64_t>(502);
+			pduel->write_message<MSG_HINT>(HINT_SELECTMSG, check_player, 502);
 			emplace_process<Processors::SelectCard>(check_player, false, ct, ct);
 		} else
 			arg.step = 2;
@@ -2047,10 +2018,10 @@ bool field::process(Processors::Equip& arg) {
 			if(equip_card->is_position(POS_FACEUP))
 				equip_card->enable_field_effect(true);
 			adjust_disable_check_list();
-			card_set cset;
-			cset.insert(equip_card);
-			raise_single_event(target, &cset, EVENT_EQUIP, core.reason_effect, 0, core.reason_player, PLAYER_NONE, 0);
-			raise_event(std::move(cset), EVENT_EQUIP, core.reason_effect, 0, core.reason_player, PLAYER_NONE, 0);
+			auto ng = pduel->new_group(equip_card);
+			ng->is_readonly = true;
+			raise_single_event(target, ng, EVENT_EQUIP, core.reason_effect, 0, core.reason_player, PLAYER_NONE, 0);
+			raise_event(ng, EVENT_EQUIP, core.reason_effect, 0, core.reason_player, PLAYER_NONE, 0);
 			core.hint_timing[target->overlay_target ? target->overlay_target->current.controler : target->current.controler] |= TIMING_EQUIP;
 			process_single_event();
 			process_instant_event();
@@ -2419,20 +2390,14 @@ bool field::process(Processors::SummonRule& arg) {
 			}
 			if(pdec) {
 				min -= minul;
-				auto message = pduel->new_message(MSG_HINT);
-				message->write<uint8_t>(HINT_CARD);
-				message->write<uint8_t>(0);
-				message->write<uint64_t>(pdec->handler->data.code);
+				pduel->write_message<MSG_HINT>(HINT_CARD, 0, pdec->handler->data.code);
 			}
 			for(const auto& peffect : eset) {
 				if(peffect->is_flag(EFFECT_FLAG_COUNT_LIMIT) && peffect->count_limit > 0 && peffect->target) {
 					int32_t dec = peffect->get_value(target);
 					min -= dec & 0xffff;
 					peffect->dec_count();
-					auto message = pduel->new_message(MSG_HINT);
-					message->write<uint8_t>(HINT_CARD);
-					message->write<uint8_t>(0);
-					message->write<uint64_t>(peffect->handler->data.code);
+					pduel->write_message<MSG_HINT>(HINT_CARD, 0, peffect->handler->data.code);
 					if(min <= 0)
 						break;
 				}
@@ -2442,10 +2407,7 @@ bool field::process(Processors::SummonRule& arg) {
 					int32_t dec = peffect->get_value(target);
 					min -= dec & 0xffff;
 					peffect->dec_count();
-					auto message = pduel->new_message(MSG_HINT);
-					message->write<uint8_t>(HINT_CARD);
-					message->write<uint8_t>(0);
-					message->write<uint64_t>(peffect->handler->data.code);
+					pduel->write_message<MSG_HINT>(HINT_CARD, 0, peffect->handler->data.code);
 					if(min <= 0)
 						break;
 				}
@@ -2510,10 +2472,7 @@ bool field::process(Processors::SummonRule& arg) {
 			++core.summon_count[sumplayer];
 		else {
 			core.extra_summon[sumplayer] = TRUE;
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_CARD);
-			message->write<uint8_t>(0);
-			message->write<uint64_t>(pextra->handler->data.code);
+			pduel->write_message<MSG_HINT>(HINT_CARD, 0, pextra->handler->data.code);
 			if(pextra->operation) {
 				pduel->lua->add_param<LuaParam::CARD>(target);
 				core.sub_solving_event.push_back(nil_event);
@@ -2600,10 +2559,7 @@ bool field::process(Processors::SummonRule& arg) {
 			++core.summon_count[sumplayer];
 		else {
 			core.extra_summon[sumplayer] = TRUE;
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_CARD);
-			message->write<uint8_t>(0);
-			message->write<uint64_t>(pextra->handler->data.code);
+			pduel->write_message<MSG_HINT>(HINT_CARD, 0, pextra->handler->data.code);
 			if(pextra->operation) {
 				pduel->lua->add_param<LuaParam::CARD>(target);
 				core.sub_solving_event.push_back(nil_event);
@@ -2693,7 +2649,7 @@ bool field::process(Processors::SummonRule& arg) {
 		return FALSE;
 	}
 	case 17: {
-		pduel->new_message(MSG_SUMMONED);
+		pduel->write_message<MSG_SUMMONED>();
 		adjust_instant();
 		if(target->material_cards.size()) {
 			for(auto& mcard : target->material_cards)
@@ -2801,7 +2757,7 @@ bool field::process(Processors::FlipSummon& arg) {
 		return FALSE;
 	}
 	case 4: {
-		pduel->new_message(MSG_FLIPSUMMONED);
+		pduel->write_message<MSG_FLIPSUMMONED>();
 		if(!is_flag(DUEL_CANNOT_SUMMON_OATH_OLD)) {
 			++core.flipsummon_state_count[sumplayer];
 			check_card_counter(target, ACTIVITY_FLIPSUMMON, sumplayer);
@@ -3151,10 +3107,7 @@ bool field::process(Processors::MonsterSet& arg) {
 			++core.summon_count[setplayer];
 		else {
 			core.extra_summon[setplayer] = TRUE;
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_CARD);
-			message->write<uint8_t>(0);
-			message->write<uint64_t>(pextra->handler->data.code);
+			pduel->write_message<MSG_HINT>(HINT_CARD, 0, pextra->handler->data.code);
 			if(pextra->operation) {
 				pduel->lua->add_param<LuaParam::CARD>(target);
 				core.sub_solving_event.push_back(nil_event);
@@ -3377,10 +3330,7 @@ bool field::process(Processors::SpellSetGroup& arg) {
 			    flag = ((flag & 0xff00) << 16) | 0xe0ffffff;
 		}
 		///kdiy///////
-		auto message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_SELECTMSG);
-		message->write<uint8_t>(setplayer);
-		message->write<uint64_t>(target->data.code);
+		pduel->write_message<MSG_HINT>(HINT_SELECTMSG, setplayer, target->data.code);
 		emplace_process<Processors::SelectPlace>(setplayer, flag, 1);
 		return FALSE;
 	}
@@ -3762,7 +3712,7 @@ bool field::process(Processors::SpSummonRule& arg) {
 		return FALSE;
 	}
 	case 16: {
-		pduel->new_message(MSG_SPSUMMONED);
+		pduel->write_message<MSG_SPSUMMONED>();
 		adjust_instant();
 		auto proc = arg.summon_proc_effect;
 		int32_t matreason = REASON_SPSUMMON;
@@ -4023,7 +3973,7 @@ bool field::process(Processors::SpSummonRule& arg) {
 	}
 	case 28: {
 		auto pgroup = arg.cards_to_summon_g;
-		pduel->new_message(MSG_SPSUMMONED);
+		pduel->write_message<MSG_SPSUMMONED>();
 		if(!is_flag(DUEL_CANNOT_SUMMON_OATH_OLD)) {
 			set_spsummon_counter(sumplayer);
 			check_card_counter(pgroup, ACTIVITY_SPSUMMON, sumplayer);
@@ -4040,11 +3990,13 @@ bool field::process(Processors::SpSummonRule& arg) {
 		for(auto& pcard : pgroup->container)
 			raise_single_event(pcard, nullptr, EVENT_SPSUMMON_SUCCESS, pcard->current.reason_effect, 0, pcard->current.reason_player, pcard->summon.player, 0);
 		process_single_event();
+		auto ng = pduel->new_group(pgroup->container);
+		ng->is_readonly = true;
 		////kdiy////////
-		raise_event(pgroup->container, EVENT_PRESPSUMMON_SUCCESS, arg.summon_proc_effect, 0, sumplayer, sumplayer, 0);
+		raise_event(ng, EVENT_PRESPSUMMON_SUCCESS, arg.summon_proc_effect, 0, sumplayer, sumplayer, 0);
 		process_instant_event();
 		////kdiy////////
-		raise_event(pgroup->container, EVENT_SPSUMMON_SUCCESS, arg.summon_proc_effect, 0, sumplayer, sumplayer, 0);
+		raise_event(ng, EVENT_SPSUMMON_SUCCESS, arg.summon_proc_effect, 0, sumplayer, sumplayer, 0);
 		process_instant_event();
 		if(core.current_chain.size() == 0) {
 			adjust_all();
@@ -4321,7 +4273,8 @@ bool field::process(Processors::SpSummon& arg) {
 		return FALSE;
 	}
 	case 3: {
-		pduel->new_message(MSG_SPSUMMONED);
+		pduel->write_message<MSG_SPSUMMONED>();
+		owned_lua<group> summoned;
 		for(auto& pcard : targets->container) {
 			if(!is_flag(DUEL_CANNOT_SUMMON_OATH_OLD)) {
 				check_card_counter(pcard, ACTIVITY_SPSUMMON, pcard->summon.player);
@@ -4339,8 +4292,12 @@ bool field::process(Processors::SpSummon& arg) {
 					matreason = REASON_XYZ;
 				else if(summontype == SUMMON_TYPE_LINK)
 					matreason = REASON_LINK;
+				if(!summoned) {
+					summoned = pduel->new_group(targets->container);
+					summoned->is_readonly = true;
+				}
 				for(auto& mcard : pcard->material_cards)
-					raise_single_event(mcard, &targets->container, EVENT_BE_MATERIAL, pcard->current.reason_effect, matreason, pcard->current.reason_player, pcard->summon.player, 0);
+					raise_single_event(mcard, summoned, EVENT_BE_MATERIAL, pcard->current.reason_effect, matreason, pcard->current.reason_player, pcard->summon.player, 0);
 				raise_event(pcard->material_cards, EVENT_BE_MATERIAL, reason_effect, matreason, reason_player, pcard->summon.player, 0);
 			}
 			pcard->set_status(STATUS_FUTURE_FUSION, FALSE);
@@ -4528,10 +4485,7 @@ bool field::process(Processors::Destroy& arg) {
 		}
 		for (auto& peffect : indestructable_effect_set) {
 			peffect->dec_count();
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_CARD);
-			message->write<uint8_t>(0);
-			message->write<uint64_t>(peffect->owner->data.code);
+			pduel->write_message<MSG_HINT>(HINT_CARD, 0, peffect->owner->data.code);
 		}
 		operation_replace(EFFECT_DESTROY_REPLACE, 5, targets);
 		return FALSE;
@@ -4627,10 +4581,7 @@ bool field::process(Processors::Destroy& arg) {
 					pduel->lua->add_param<LuaParam::INT>(pcard->current.reason);
 					pduel->lua->add_param<LuaParam::INT>(pcard->current.reason_player);
 					if(peff->check_value_condition(3)) {
-						auto message = pduel->new_message(MSG_HINT);
-						message->write<uint8_t>(HINT_CARD);
-						message->write<uint8_t>(0);
-						message->write<uint64_t>(peff->owner->data.code);
+						pduel->write_message<MSG_HINT>(HINT_CARD, 0, peff->owner->data.code);
 						indes = true;
 						break;
 					}
@@ -4657,10 +4608,7 @@ bool field::process(Processors::Destroy& arg) {
 						pduel->lua->add_param<LuaParam::INT>(pcard->current.reason_player);
 						if(peff->check_value_condition(3)) {
 							peff->dec_count();
-							auto message = pduel->new_message(MSG_HINT);
-							message->write<uint8_t>(HINT_CARD);
-							message->write<uint8_t>(0);
-							message->write<uint64_t>(peff->owner->data.code);
+							pduel->write_message<MSG_HINT>(HINT_CARD, 0, peff->owner->data.code);
 							indes = true;
 						}
 					} else {
@@ -4671,10 +4619,7 @@ bool field::process(Processors::Destroy& arg) {
 						if(ct) {
 							auto it = pcard->indestructable_effects.emplace(peff->id, 0);
 							if(++it.first->second <= ct) {
-								auto message = pduel->new_message(MSG_HINT);
-								message->write<uint8_t>(HINT_CARD);
-								message->write<uint8_t>(0);
-								message->write<uint64_t>(peff->owner->data.code);
+								pduel->write_message<MSG_HINT>(HINT_CARD, 0, peff->owner->data.code);
 								indes = true;
 							}
 						}
@@ -4815,10 +4760,7 @@ bool field::process(Processors::Release& arg) {
 	}
 	case 3: {
 		for(auto& peffect : core.dec_count_reserve) {
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_CARD);
-			message->write<uint8_t>(0);
-			message->write<uint64_t>(peffect->get_handler()->data.code);
+			pduel->write_message<MSG_HINT>(HINT_CARD, 0, peffect->get_handler()->data.code);
 		}
 		auto sendtargets = pduel->new_group(targets->container);
 		sendtargets->is_readonly = true;
@@ -5176,10 +5118,7 @@ bool field::process(Processors::SendTo& arg) {
         else
 			flag = ((flag & 0xff00)) | 0xffffe0ff;
 		/////kdiy////
-		auto message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_SELECTMSG);
-		message->write<uint8_t>(pcard->current.controler);
-		message->write<uint64_t>(pcard->data.code);
+		pduel->write_message<MSG_HINT>(HINT_SELECTMSG, pcard->current.controler, pcard->data.code);
 		emplace_process<Processors::SelectPlace>(pcard->current.controler, flag, 1);
 		return FALSE;
 	}
@@ -5632,10 +5571,7 @@ bool field::process(Processors::MoveToField& arg) {
 			if(move_player != playerid)
 				flag = flag << 16;
 			flag = ~flag;
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_SELECTMSG);
-			message->write<uint8_t>(move_player);
-			message->write<uint64_t>(target->data.code);
+			pduel->write_message<MSG_HINT>(HINT_SELECTMSG, move_player, target->data.code);
 			emplace_process<Processors::SelectPlace>(move_player, flag, 1);
 		} else {
 			uint32_t flag;
@@ -5734,10 +5670,7 @@ bool field::process(Processors::MoveToField& arg) {
 				    //////kdiy/////
 			}	
 			flag |= 0xe080e080;			
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_SELECTMSG);
-			message->write<uint8_t>(move_player);
-			message->write<uint64_t>(target->data.code);
+			pduel->write_message<MSG_HINT>(HINT_SELECTMSG, move_player, target->data.code);
 			emplace_process<Processors::SelectPlace>(move_player, flag, 1);
 		}
 		return FALSE;
@@ -6064,10 +5997,7 @@ bool field::process(Processors::ChangePos& arg) {
 				for(auto& pcard : ssets)
 					core.select_cards.push_back(pcard);
 				uint32_t ct = (uint32_t)ssets.size() - fcount;
-				auto message = pduel->new_message(MSG_HINT);
-				message->write<uint8_t>(HINT_SELECTMSG);
-				message->write<uint8_t>(playerid);
-				message->write<uint64_t>(502);
+				pduel->write_message<MSG_HINT>(HINT_SELECTMSG, playerid, 502);
 				emplace_process<Processors::SelectCard>(playerid, false, ct, ct);
 			}
 		} else
@@ -6540,10 +6470,7 @@ bool field::process(Processors::SelectRelease& arg) {
 		}
 		if(allmust)
 			min = static_cast<uint16_t>(core.release_cards_ex.size());
-		auto message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_SELECTMSG);
-		message->write<uint8_t>(playerid);
-		message->write<uint64_t>(500);
+		pduel->write_message<MSG_HINT>(HINT_SELECTMSG, playerid, 500);
 		emplace_process<Processors::SelectCard>(playerid, cancelable, min, max);
 		return FALSE;
 	}
@@ -6614,10 +6541,7 @@ bool field::process(Processors::SelectRelease& arg) {
 		std::set_difference(diff.begin(), diff.end(), core.unselect_cards.begin(), core.unselect_cards.end(),
 							std::inserter(core.select_cards, core.select_cards.begin()), card_sort());
 
-		auto message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_SELECTMSG);
-		message->write<uint8_t>(playerid);
-		message->write<uint64_t>(500);
+		pduel->write_message<MSG_HINT>(HINT_SELECTMSG, playerid, 500);
 		emplace_process<Processors::SelectUnselectCard>(playerid, finishable || core.operated_set.empty(), min, max, finishable);
 		return FALSE;
 	}
@@ -6668,10 +6592,7 @@ bool field::process(Processors::SelectTribute& arg) {
 		zone &= (0x1f & get_forced_zones(target, toplayer, LOCATION_MZONE, playerid, LOCATION_REASON_TOFIELD));
 		int32_t ct = get_tofield_count(target, toplayer, LOCATION_MZONE, playerid, LOCATION_REASON_TOFIELD, zone);
 		if(ct > 0) {
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_SELECTMSG);
-			message->write<uint8_t>(playerid);
-			message->write<uint64_t>(500);
+			pduel->write_message<MSG_HINT>(HINT_SELECTMSG, playerid, 500);
 			if(core.release_cards_ex.size() + core.release_cards_ex_oneof.size() == 0) {
 				core.select_cards.clear();
 				for(auto& pcard : core.release_cards)
@@ -6703,10 +6624,7 @@ bool field::process(Processors::SelectTribute& arg) {
 					must_choose_one.insert(pcard);
 			rmax += (pcard)->release_param;
 		}
-		auto message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_SELECTMSG);
-		message->write<uint8_t>(playerid);
-		message->write<uint64_t>(500);
+		pduel->write_message<MSG_HINT>(HINT_SELECTMSG, playerid, 500);
 		if(core.release_cards_ex.empty() && core.release_cards_ex_oneof.empty() && min > rmax) {
 			if(rmax > 0) {
 				core.select_cards.clear();
@@ -6805,10 +6723,7 @@ bool field::process(Processors::SelectTribute& arg) {
 		auto finishable = min == 0 && !force && !exsize;
 		for(auto& pcard : core.operated_set)
 			core.unselect_cards.push_back(pcard);
-		auto message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_SELECTMSG);
-		message->write<uint8_t>(playerid);
-		message->write<uint64_t>(500);
+		pduel->write_message<MSG_HINT>(HINT_SELECTMSG, playerid, 500);
 		emplace_process<Processors::SelectUnselectCard>(playerid, canc, oldmin, oldmax, finishable);
 		return FALSE;
 	}
@@ -207,10 +207,7 @@ bool field::process(Processors::SelectOption& arg) {
 	if(arg.step == 0) {
 		returns.set<int32_t>(0, -1);
 		if(core.select_options.size() == 0) {
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_SELECTMSG);
-			message->write<uint8_t>(playerid);
-			message->write<uint64_t>(0);
+			pduel->write_message<MSG_HINT>(HINT_SELECTMSG, playerid, 0);
 			return TRUE;
 		}
 		if((playerid == 1) && is_flag(DUEL_SIMPLE_AI)) {
@@ -285,10 +282,7 @@ bool field::process(Processors::SelectCard& arg) {
 		return_cards.clear();
 		returns.clear();
 		if(max == 0 || core.select_cards.empty()) {
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_SELECTMSG);
-			message->write<uint8_t>(playerid);
-			message->write<uint64_t>(0);
+			pduel->write_message<MSG_HINT>(HINT_SELECTMSG, playerid, 0);
 			return TRUE;
 		}
 		if(max > core.select_cards.size())
@@ -340,10 +334,7 @@ bool field::process(Processors::SelectCardCodes& arg) {
 		return_card_codes.clear();
 		returns.clear();
 		if(max == 0 || core.select_cards_codes.empty()) {
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_SELECTMSG);
-			message->write<uint8_t>(playerid);
-			message->write<uint64_t>(0);
+			pduel->write_message<MSG_HINT>(HINT_SELECTMSG, playerid, 0);
 			return TRUE;
 		}
 		if(max > core.select_cards_codes.size())
@@ -395,10 +386,7 @@ bool field::process(Processors::SelectUnselectCard& arg) {
 		return_cards.clear();
 		returns.clear();
 		if (core.select_cards.empty() && core.unselect_cards.empty()) {
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_SELECTMSG);
-			message->write<uint8_t>(playerid);
-			message->write<uint64_t>(0);
+			pduel->write_message<MSG_HINT>(HINT_SELECTMSG, playerid, 0);
 			return TRUE;
 		}
 		if ((playerid == 1) && is_flag(DUEL_SIMPLE_AI)) {
@@ -508,10 +496,7 @@ bool field::process(Processors::SelectPlace& arg) {
 	auto disable_field = arg.disable_field;
 	if(arg.step == 0) {
 		if(count == 0) {
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_SELECTMSG);
-			message->write<uint8_t>(playerid);
-			message->write<uint64_t>(0);
+			pduel->write_message<MSG_HINT>(HINT_SELECTMSG, playerid, 0);
 			return TRUE;
 		}
 		if((playerid == 1) && is_flag(DUEL_SIMPLE_AI)) {
@@ -645,10 +630,7 @@ bool field::process(Processors::SelectTributeP& arg) {
 		returns.clear();
 		return_cards.clear();
 		if(max == 0 || core.select_cards.empty()) {
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_SELECTMSG);
-			message->write<uint8_t>(playerid);
-			message->write<uint64_t>(0);
+			pduel->write_message<MSG_HINT>(HINT_SELECTMSG, playerid, 0);
 			return TRUE;
 		}
 		uint8_t tm = 0;
@@ -787,10 +769,7 @@ bool field::process(Processors::SelectSum& arg) {
 		return_cards.clear();
 		returns.clear();
 		if(core.select_cards.empty()) {
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_SELECTMSG);
-			message->write<uint8_t>(playerid);
-			message->write<uint64_t>(0);
+			pduel->write_message<MSG_HINT>(HINT_SELECTMSG, playerid, 0);
 			return TRUE;
 		}
 		auto message = pduel->new_message(MSG_SELECT_SUM);
@@ -878,10 +857,7 @@ bool field::process(Processors::SortCard& arg) {
 			return TRUE;
 		}
 		if(core.select_cards.empty()) {
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_SELECTMSG);
-			message->write<uint8_t>(playerid);
-			message->write<uint64_t>(0);
+			pduel->write_message<MSG_HINT>(HINT_SELECTMSG, playerid, 0);
 			return TRUE;
 		}
 		auto message = pduel->new_message((is_chain) ? MSG_SORT_CHAIN : MSG_SORT_CARD);
@@ -917,10 +893,7 @@ bool field::process(Processors::AnnounceRace& arg) {
 	auto available = arg.available;
 	if(arg.step == 0) {
 		if(count == 0) {
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_SELECTMSG);
-			message->write<uint8_t>(playerid);
-			message->write<uint64_t>(0);
+			pduel->write_message<MSG_HINT>(HINT_SELECTMSG, playerid, 0);
 			return TRUE;
 		}
 		auto message = pduel->new_message(MSG_ANNOUNCE_RACE);
@@ -938,10 +911,7 @@ bool field::process(Processors::AnnounceRace& arg) {
 			pduel->new_message(MSG_RETRY);
 			return FALSE;
 		}
-		auto message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_RACE);
-		message->write<uint8_t>(playerid);
-		message->write<uint64_t>(returns.at<uint64_t>(0));
+		pduel->write_message<MSG_HINT>(HINT_RACE, playerid, returns.at<uint64_t>(0));
 		return TRUE;
 	}
 	return TRUE;
@@ -952,10 +922,7 @@ bool field::process(Processors::AnnounceAttribute& arg) {
 	auto available = arg.available;
 	if(arg.step == 0) {
 		if(count == 0) {
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_SELECTMSG);
-			message->write<uint8_t>(playerid);
-			message->write<uint64_t>(0);
+			pduel->write_message<MSG_HINT>(HINT_SELECTMSG, playerid, 0);
 			return TRUE;
 		}
 		auto message = pduel->new_message(MSG_ANNOUNCE_ATTRIB);
@@ -973,10 +940,7 @@ bool field::process(Processors::AnnounceAttribute& arg) {
 			pduel->new_message(MSG_RETRY);
 			return FALSE;
 		}
-		auto message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_ATTRIB);
-		message->write<uint8_t>(playerid);
-		message->write<uint64_t>(returns.at<uint32_t>(0));
+		pduel->write_message<MSG_HINT>(HINT_ATTRIB, playerid, returns.at<uint32_t>(0));
 		return TRUE;
 	}
 	return TRUE;
@@ -1097,10 +1061,7 @@ bool field::process(Processors::AnnounceCard& arg) {
 			/*auto message = */pduel->new_message(MSG_RETRY);
 			return FALSE;
 		}
-		auto message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_CODE);
-		message->write<uint8_t>(playerid);
-		message->write<uint64_t>(code);
+		pduel->write_message<MSG_HINT>(HINT_CODE, playerid, code);
 		return TRUE;
 	}
 	return TRUE;
@@ -1120,10 +1081,7 @@ bool field::process(Processors::AnnounceNumber& arg) {
 			pduel->new_message(MSG_RETRY);
 			return FALSE;
 		}
-		auto message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_NUMBER);
-		message->write<uint8_t>(playerid);
-		message->write<uint64_t>(core.select_options[returns.at<int32_t>(0)]);
+		pduel->write_message<MSG_HINT>(HINT_NUMBER, playerid, core.select_options[returns.at<int32_t>(0)]);
 		return TRUE;
 	}
 }
@@ -125,3 +125,14 @@ project "ocgcoreshared"
 	staticruntime "on"
 	visibility "Hidden"
 	ocgcore_config()
+
+if not subproject then
+	project "ocgcore_mt_runner"
+		kind "ConsoleApp"
+		cppdialect "C++17"
+		files { "tools/ocgcore_mt_runner.cpp" }
+		links { "ocgcore", "lua" }
+		filter "system:not windows"
+			links { "pthread" }
+		filter {}
+end
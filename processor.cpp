@@ -194,28 +194,31 @@ bool field::process(Processors::ExecuteTarget& arg) {
 	return FALSE;
 }
 void field::raise_event(card* event_card, uint32_t event_code, effect* reason_effect, uint32_t reason, uint8_t reason_player, uint8_t event_player, uint32_t event_value) {
-	auto& new_event = core.queue_event.emplace_back();
-	new_event.trigger_card = nullptr;
-	if (event_card) {
-		auto pgroup = pduel->new_group(event_card);
-		pgroup->is_readonly = true;
-		new_event.event_cards = pgroup;
-	} else
-		new_event.event_cards = nullptr;
-	new_event.event_code = event_code;
-	new_event.reason_effect = reason_effect;
-	new_event.reason = reason;
-	new_event.reason_player = reason_player;
-	new_event.event_player = event_player;
-	new_event.event_value = event_value;
-	new_event.global_id = infos.event_id;
+	if(!event_card) {
+		raise_event(owned_lua<group>{}, event_code, reason_effect, reason, reason_player, event_player, event_value);
+		return;
+	}
+	auto pgroup = pduel->new_group(event_card);
+	pgroup->is_readonly = true;
+	++core.event_groups_created;
+	raise_event(pgroup, event_code, reason_effect, reason, reason_player, event_player, event_value);
 }
 void field::raise_event(card_set event_cards, uint32_t event_code, effect* reason_effect, uint32_t reason, uint8_t reason_player, uint8_t event_player, uint32_t event_value) {
-	auto& new_event = core.queue_event.emplace_back();
-	new_event.trigger_card = nullptr;
 	auto pgroup = pduel->new_group(std::move(event_cards));
 	pgroup->is_readonly = true;
-	new_event.event_cards = pgroup;
+	++core.event_groups_created;
+	raise_event(pgroup, event_code, reason_effect, reason, reason_player, event_player, event_value);
+}
+/*
+	The group is shared as is by the event, it must be read only and must not be modified
+	by the core afterwards, this allows raising multiple events on the same set of cards
+	without copying it each time.
+*/
+void field::raise_event(const owned_lua<group>& event_cards, uint32_t event_code, effect* reason_effect, uint32_t reason, uint8_t reason_player, uint8_t event_player, uint32_t event_value) {
+	++core.events_raised;
+	auto& new_event = core.queue_event.emplace_back();
+	new_event.trigger_card = nullptr;
+	new_event.event_cards = event_cards;
 	new_event.event_code = event_code;
 	new_event.reason_effect = reason_effect;
 	new_event.reason = reason;
@@ -225,14 +228,20 @@ void field::raise_event(card_set event_cards, uint32_t event_code, effect* reaso
 	new_event.global_id = infos.event_id;
 }
 void field::raise_single_event(card* trigger_card, card_set* event_cards, uint32_t event_code, effect* reason_effect, uint32_t reason, uint8_t reason_player, uint8_t event_player, uint32_t event_value) {
+	if(!event_cards) {
+		raise_single_event(trigger_card, owned_lua<group>{}, event_code, reason_effect, reason, reason_player, event_player, event_value);
+		return;
+	}
+	auto pgroup = pduel->new_group(*event_cards);
+	pgroup->is_readonly = true;
+	++core.event_groups_created;
+	raise_single_event(trigger_card, pgroup, event_code, reason_effect, reason, reason_player, event_player, event_value);
+}
+void field::raise_single_event(card* trigger_card, const owned_lua<group>& event_cards, uint32_t event_code, effect* reason_effect, uint32_t reason, uint8_t reason_player, uint8_t event_player, uint32_t event_value) {
+	++core.events_raised;
 	auto& new_event = core.single_event.emplace_back();
 	new_event.trigger_card = trigger_card;
-	if (event_cards) {
-		auto pgroup = pduel->new_group(*event_cards);
-		pgroup->is_readonly = true;
-		new_event.event_cards = pgroup;
-	} else
-		new_event.event_cards = nullptr;
+	new_event.event_cards = event_cards;
 	new_event.event_code = event_code;
 	new_event.reason_effect = reason_effect;
 	new_event.reason = reason;
@@ -426,19 +435,16 @@ bool field::process(Processors::PhaseEvent& arg) {
 			arg.step = 1;
 			return FALSE;
 		} else {
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_EVENT);
-			message->write<uint8_t>(check_player);
+			uint64_t hint = 26;
 			if(infos.phase == PHASE_DRAW)
-				message->write<uint64_t>(20);
+				hint = 20;
 			else if(infos.phase == PHASE_STANDBY)
-				message->write<uint64_t>(21);
+				hint = 21;
 			else if(infos.phase == PHASE_BATTLE_START)
-				message->write<uint64_t>(28);
+				hint = 28;
 			else if(infos.phase == PHASE_BATTLE)
-				message->write<uint64_t>(25);
-			else
-				message->write<uint64_t>(26);
+				hint = 25;
+			pduel->write_message<MSG_HINT>(HINT_EVENT, check_player, hint);
 			if(tf_count == 0 && to_count == 1 && fc_count == 0 && cn_count == 0) {
 				emplace_process<Processors::SelectEffectYesNo>(check_player, 0, core.select_chains.front().triggering_effect->get_handler());
 				return FALSE;
@@ -537,10 +543,7 @@ bool field::process(Processors::PhaseEvent& arg) {
 		core.select_cards.clear();
 		for(auto& pcard : player[infos.turn_player].list_hand)
 			core.select_cards.push_back(pcard);
-		auto message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_SELECTMSG);
-		message->write<uint8_t>(infos.turn_player);
-		message->write<uint64_t>(501);
+		pduel->write_message<MSG_HINT>(HINT_SELECTMSG, infos.turn_player, 501);
 		auto to_discard = hd - limit;
 		emplace_process<Processors::SelectCard>(infos.turn_player, false, to_discard, to_discard);
 		return FALSE;
@@ -1226,10 +1229,16 @@ int32_t field::process_instant_event() {
 			effect* peffect = eit->second;
 			++eit;
 			card* phandler = peffect->get_handler();
-			if(!phandler->is_status(STATUS_EFFECT_ENABLED) || !peffect->is_condition_check(phandler->current.controler, ev))
+			if(!phandler->is_status(STATUS_EFFECT_ENABLED))
 				continue;
-			bool was_just_sent = false;
-			if((was_just_sent = check_simul(peffect, phandler)) == true && (peffect->range & LOCATION_HAND) == 0)
+			// the cheap checks that discard the effect go first, to not call its condition for nothing
+			const bool was_just_sent = check_simul(peffect, phandler);
+			if(was_just_sent && (peffect->range & LOCATION_HAND) == 0) {
+				if(peffect->condition)
+					++core.event_condition_checks_skipped;
+				continue;
+			}
+			if(!peffect->is_condition_check(phandler->current.controler, ev))
 				continue;
 			peffect->set_activate_location();
 			auto& newchain = core.new_fchain.emplace_back();
@@ -1251,10 +1260,13 @@ int32_t field::process_instant_event() {
 			effect* peffect = eit->second;
 			++eit;
 			card* phandler = peffect->get_handler();
-			bool act = phandler->is_status(STATUS_EFFECT_ENABLED) && peffect->is_condition_check(phandler->current.controler, ev);
-			bool was_just_sent = false;
-			if((was_just_sent = check_simul(peffect, phandler)) == true && (peffect->range & LOCATION_HAND) == 0)
+			const bool was_just_sent = check_simul(peffect, phandler);
+			if(was_just_sent && (peffect->range & LOCATION_HAND) == 0) {
+				if(peffect->condition && phandler->is_status(STATUS_EFFECT_ENABLED))
+					++core.event_condition_checks_skipped;
 				continue;
+			}
+			bool act = phandler->is_status(STATUS_EFFECT_ENABLED) && peffect->is_condition_check(phandler->current.controler, ev);
 			if((peffect->range & LOCATION_HAND) == 0 && !act)
 				continue;
 			peffect->set_activate_location();
@@ -1673,10 +1685,7 @@ bool field::process(Processors::IdleCommand& arg) {
 			return FALSE;
 		} else {
 			arg.step = 9;
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_EVENT);
-			message->write<uint8_t>(1 - infos.turn_player);
-			message->write<uint64_t>(23);
+			pduel->write_message<MSG_HINT>(HINT_EVENT, 1 - infos.turn_player, 23);
 			core.select_chains.clear();
 			core.hint_timing[infos.turn_player] = TIMING_MAIN_END;
 			emplace_process<Processors::QuickEffect>(false, 1 - infos.turn_player);
@@ -1943,10 +1952,7 @@ bool field::process(Processors::BattleCommand& arg) {
 			arg.step = 39;
 			// ignored when arg.forced_attack_done, so can be anything
 			arg.phase_to_change_to = ctype;
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_EVENT);
-			message->write<uint8_t>(1 - infos.turn_player);
-			message->write<uint64_t>(29);
+			pduel->write_message<MSG_HINT>(HINT_EVENT, 1 - infos.turn_player, 29);
 			core.select_chains.clear();
 			core.hint_timing[infos.turn_player] = TIMING_BATTLE_STEP_END;
 			emplace_process<Processors::QuickEffect>(false, 1 - infos.turn_player);
@@ -2094,10 +2100,7 @@ bool field::process(Processors::BattleCommand& arg) {
 				auto message = pduel->new_message(MSG_CARD_SELECTED);
 				message->write<uint32_t>(1);
 				message->write(core.attacker->get_info_location());
-				message = pduel->new_message(MSG_HINT);
-				message->write<uint8_t>(HINT_SELECTMSG);
-				message->write<uint8_t>(1 - infos.turn_player);
-				message->write<uint64_t>(549);
+				pduel->write_message<MSG_HINT>(HINT_SELECTMSG, 1 - infos.turn_player, 549);
 				emplace_process<Processors::SelectCard>(1 - infos.turn_player, false, 1, 1);
 				if(atype == 3 && arg.must_attack_map.size() != differentMustAttackMonsterEffects) {
 					arg.step = 15;
@@ -2105,10 +2108,7 @@ bool field::process(Processors::BattleCommand& arg) {
 				}
 			}
 		} else {
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_SELECTMSG);
-			message->write<uint8_t>(infos.turn_player);
-			message->write<uint64_t>(549);
+			pduel->write_message<MSG_HINT>(HINT_SELECTMSG, infos.turn_player, 549);
 			emplace_process<Processors::SelectCard>(infos.turn_player, core.attack_cancelable, 1, 1);
 		}
 		arg.step = 5;
@@ -2123,10 +2123,7 @@ bool field::process(Processors::BattleCommand& arg) {
 				auto opposel = !!is_player_affected_by_effect(infos.turn_player, EFFECT_PATRICIAN_OF_DARKNESS);
 				const auto sel_player = opposel ? 1 - infos.turn_player : infos.turn_player;
 				const auto cancelable = (core.attack_cancelable && !opposel);
-				auto message = pduel->new_message(MSG_HINT);
-				message->write<uint8_t>(HINT_SELECTMSG);
-				message->write<uint8_t>(opposel ? 1 - infos.turn_player : infos.turn_player);
-				message->write<uint64_t>(549);
+				pduel->write_message<MSG_HINT>(HINT_SELECTMSG, opposel ? 1 - infos.turn_player : infos.turn_player, 549);
 				emplace_process<Processors::SelectCard>(sel_player, cancelable, 1, 1);
 			} else {
 				arg.attack_announce_failed = true;
@@ -2228,14 +2225,8 @@ bool field::process(Processors::BattleCommand& arg) {
 			arg.step = 10;
 			return FALSE;
 		}
-		auto message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_EVENT);
-		message->write<uint8_t>(0);
-		message->write<uint64_t>(24);
-		message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_EVENT);
-		message->write<uint8_t>(1);
-		message->write<uint64_t>(24);
+		pduel->write_message<MSG_HINT>(HINT_EVENT, 0, 24);
+		pduel->write_message<MSG_HINT>(HINT_EVENT, 1, 24);
 		core.hint_timing[0] = TIMING_BATTLE_PHASE;
 		core.hint_timing[1] = TIMING_BATTLE_PHASE;
 		emplace_process<Processors::PointEvent>(Step{ 30 }, false, false, false);
@@ -2251,7 +2242,7 @@ bool field::process(Processors::BattleCommand& arg) {
 	case 11: {
 		if(core.attacker->is_affected_by_effect(EFFECT_ATTACK_DISABLED)) {
 			core.attacker->reset(EFFECT_ATTACK_DISABLED, RESET_CODE);
-			pduel->new_message(MSG_ATTACK_DISABLED);
+			pduel->write_message<MSG_ATTACK_DISABLED>();
 			core.attacker->set_status(STATUS_ATTACK_CANCELED, TRUE);
 		}
 		///////kdiy///////
@@ -2347,10 +2338,7 @@ bool field::process(Processors::BattleCommand& arg) {
 		std::transform(range.first, range.second, std::back_inserter(core.select_cards), [](const auto& pair) {
 			return pair.second;
 		});
-		auto message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_SELECTMSG);
-		message->write<uint8_t>(infos.turn_player);
-		message->write<uint64_t>(549);
+		pduel->write_message<MSG_HINT>(HINT_SELECTMSG, infos.turn_player, 549);
 		emplace_process<Processors::SelectCard>(infos.turn_player, core.attack_cancelable, 1, 1);
 		arg.step = 5;
 		return FALSE;
@@ -2377,7 +2365,7 @@ bool field::process(Processors::BattleCommand& arg) {
 	}
 	case 20: {
 		// start of PHASE_DAMAGE;
-		(void)pduel->new_message(MSG_DAMAGE_STEP_START);
+		pduel->write_message<MSG_DAMAGE_STEP_START>();
 		raise_single_event(core.attacker, nullptr, EVENT_BATTLE_START, nullptr, 0, 0, 0, 0);
 		if(core.attack_target) {
 			raise_single_event(core.attack_target, nullptr, EVENT_BATTLE_START, nullptr, 0, 0, 0, 1);
@@ -2388,14 +2376,8 @@ bool field::process(Processors::BattleCommand& arg) {
 		arg.previous_point_event_had_any_trigger_to_resolve = false;
 		if(!is_flag(DUEL_6_STEP_BATLLE_STEP) || (core.new_fchain.size() || core.new_ochain.size())) {
 			arg.previous_point_event_had_any_trigger_to_resolve = core.new_fchain.size() || core.new_ochain.size();
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_EVENT);
-			message->write<uint8_t>(0);
-			message->write<uint64_t>(40);
-			message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_EVENT);
-			message->write<uint8_t>(1);
-			message->write<uint64_t>(40);
+			pduel->write_message<MSG_HINT>(HINT_EVENT, 0, 40);
+			pduel->write_message<MSG_HINT>(HINT_EVENT, 1, 40);
 			emplace_process<Processors::PointEvent>(false, false, is_flag(DUEL_SINGLE_CHAIN_IN_DAMAGE_SUBSTEP));
 		}
 		return FALSE;
@@ -2428,14 +2410,8 @@ bool field::process(Processors::BattleCommand& arg) {
 		process_instant_event();
 		if(!is_flag(DUEL_6_STEP_BATLLE_STEP) || !arg.previous_point_event_had_any_trigger_to_resolve
 		   || core.new_fchain.size() || core.new_ochain.size()) {
-			auto message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_EVENT);
-			message->write<uint8_t>(0);
-			message->write<uint64_t>(41);
-			message = pduel->new_message(MSG_HINT);
-			message->write<uint8_t>(HINT_EVENT);
-			message->write<uint8_t>(1);
-			message->write<uint64_t>(41);
+			pduel->write_message<MSG_HINT>(HINT_EVENT, 0, 41);
+			pduel->write_message<MSG_HINT>(HINT_EVENT, 1, 41);
 			core.hint_timing[infos.turn_player] = TIMING_DAMAGE_STEP;
 			emplace_process<Processors::PointEvent>(false, false, is_flag(DUEL_SINGLE_CHAIN_IN_DAMAGE_SUBSTEP));
 		}
@@ -2459,14 +2435,8 @@ bool field::process(Processors::BattleCommand& arg) {
 		raise_event(nullptr, EVENT_PRE_DAMAGE_CALCULATE, nullptr, 0, 0, 0, 0);
 		process_single_event();
 		process_instant_event();
-		auto message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_EVENT);
-		message->write<uint8_t>(0);
-		message->write<uint64_t>(42);
-		message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_EVENT);
-		message->write<uint8_t>(1);
-		message->write<uint64_t>(42);
+		pduel->write_message<MSG_HINT>(HINT_EVENT, 0, 42);
+		pduel->write_message<MSG_HINT>(HINT_EVENT, 1, 42);
 		core.hint_timing[infos.turn_player] = TIMING_DAMAGE_CAL;
 		emplace_process<Processors::PointEvent>(false, false, is_flag(DUEL_SINGLE_CHAIN_IN_DAMAGE_SUBSTEP));
 		return FALSE;
@@ -2506,10 +2476,7 @@ bool field::process(Processors::BattleCommand& arg) {
 		if(bd[0]) {
 			effect* indestructable_effect = core.attacker->is_affected_by_effect(EFFECT_INDESTRUCTABLE_BATTLE, core.attack_target);
 			if(indestructable_effect) {
-				auto message = pduel->new_message(MSG_HINT);
-				message->write<uint8_t>(HINT_CARD);
-				message->write<uint8_t>(0);
-				message->write<uint64_t>(indestructable_effect->owner->data.code);
+				pduel->write_message<MSG_HINT>(HINT_CARD, 0, indestructable_effect->owner->data.code);
 				bd[0] = false;
 			} else
 				core.attacker->set_status(STATUS_BATTLE_RESULT, TRUE);
@@ -2517,10 +2484,7 @@ bool field::process(Processors::BattleCommand& arg) {
 		if(bd[1]) {
 			effect* indestructable_effect = core.attack_target->is_affected_by_effect(EFFECT_INDESTRUCTABLE_BATTLE, core.attacker);
 			if(indestructable_effect) {
-				auto message = pduel->new_message(MSG_HINT);
-				message->write<uint8_t>(HINT_CARD);
-				message->write<uint8_t>(0);
-				message->write<uint64_t>(indestructable_effect->owner->data.code);
+				pduel->write_message<MSG_HINT>(HINT_CARD, 0, indestructable_effect->owner->data.code);
 				bd[1] = false;
 			} else
 				core.attack_target->set_status(STATUS_BATTLE_RESULT, TRUE);
@@ -2675,14 +2639,8 @@ bool field::process(Processors::BattleCommand& arg) {
 		if(is_flag(DUEL_6_STEP_BATLLE_STEP)) {
 			//EVENT_BATTLE_END was here, but this timing does not exist in Master Rule 3+
 			if(!core.effect_damage_step) {
-				auto message = pduel->new_message(MSG_HINT);
-				message->write<uint8_t>(HINT_EVENT);
-				message->write<uint8_t>(0);
-				message->write<uint64_t>(45);
-				message = pduel->new_message(MSG_HINT);
-				message->write<uint8_t>(HINT_EVENT);
-				message->write<uint8_t>(1);
-				message->write<uint64_t>(45);
+				pduel->write_message<MSG_HINT>(HINT_EVENT, 0, 45);
+				pduel->write_message<MSG_HINT>(HINT_EVENT, 1, 45);
 				core.hint_timing[infos.turn_player] = TIMING_DAMAGE_CAL;
 				emplace_process<Processors::PointEvent>(false, false, is_flag(DUEL_SINGLE_CHAIN_IN_DAMAGE_SUBSTEP));
 			} else {
@@ -2713,14 +2671,8 @@ bool field::process(Processors::BattleCommand& arg) {
 		[[fallthrough]];
 	}
 	case 32: {
-		auto message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_EVENT);
-		message->write<uint8_t>(0);
-		message->write<uint64_t>(43);
-		message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_EVENT);
-		message->write<uint8_t>(1);
-		message->write<uint64_t>(43);
+		pduel->write_message<MSG_HINT>(HINT_EVENT, 0, 43);
+		pduel->write_message<MSG_HINT>(HINT_EVENT, 1, 43);
 		core.hint_timing[0] |= TIMING_BATTLED;
 		core.hint_timing[1] |= TIMING_BATTLED;
 		emplace_process<Processors::PointEvent>(false, false, is_flag(DUEL_SINGLE_CHAIN_IN_DAMAGE_SUBSTEP));
@@ -2769,8 +2721,10 @@ bool field::process(Processors::BattleCommand& arg) {
 		if(ing.size())
 			raise_event(std::move(ing), EVENT_BATTLE_DESTROYING, nullptr, 0, 0, 0, 0);
 		if(ed.size()) {
-			raise_event(ed, EVENT_BATTLE_DESTROYED, nullptr, 0, 0, 0, 0);
-			raise_event(std::move(ed), EVENT_DESTROYED, nullptr, 0, 0, 0, 0);
+			auto ng = pduel->new_group(std::move(ed));
+			ng->is_readonly = true;
+			raise_event(ng, EVENT_BATTLE_DESTROYED, nullptr, 0, 0, 0, 0);
+			raise_event(ng, EVENT_DESTROYED, nullptr, 0, 0, 0, 0);
 		}
 		raise_single_event(core.attacker, nullptr, EVENT_DAMAGE_STEP_END, nullptr, 0, 0, 0, 0);
 		if(core.attack_target)
@@ -2781,14 +2735,8 @@ bool field::process(Processors::BattleCommand& arg) {
 			core.attack_target->set_status(STATUS_BATTLE_DESTROYED, FALSE);
 		process_single_event();
 		process_instant_event();
-		auto message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_EVENT);
-		message->write<uint8_t>(0);
-		message->write<uint64_t>(44);
-		message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_EVENT);
-		message->write<uint8_t>(1);
-		message->write<uint64_t>(44);
+		pduel->write_message<MSG_HINT>(HINT_EVENT, 0, 44);
+		pduel->write_message<MSG_HINT>(HINT_EVENT, 1, 44);
 		emplace_process<Processors::PointEvent>(false, false, true);
 		arg.step = 38;
 		return FALSE;
@@ -2807,7 +2755,7 @@ bool field::process(Processors::BattleCommand& arg) {
 		} else
 			arg.step = Processors::restart;
 		infos.phase = PHASE_BATTLE_STEP;
-		pduel->new_message(MSG_DAMAGE_STEP_END);
+		pduel->write_message<MSG_DAMAGE_STEP_END>();
 		reset_phase(PHASE_DAMAGE);
 		adjust_all();
 		if(core.effect_damage_step)
@@ -2885,14 +2833,12 @@ bool field::process(Processors::ForcedBattle& arg) {
             || (((infos.phase == PHASE_MAIN1 && is_player_affected_by_effect(infos.turn_player, EFFECT_SKIP_M1)) || (infos.phase == PHASE_MAIN2 && is_player_affected_by_effect(infos.turn_player, EFFECT_SKIP_M2))) && core.mainphase_attack)
             || core.force_turn_end) {
         ////kdiy///////////
-			auto message = pduel->new_message(MSG_NEW_PHASE);
-			message->write<uint16_t>(PHASE_BATTLE_START);
+			pduel->write_message<MSG_NEW_PHASE>(PHASE_BATTLE_START);
 			reset_phase(PHASE_BATTLE_START);
 			reset_phase(PHASE_BATTLE_STEP);
 			reset_phase(PHASE_BATTLE);
 			adjust_all();
-			message = pduel->new_message(MSG_NEW_PHASE);
-			message->write<uint16_t>(infos.phase);
+			pduel->write_message<MSG_NEW_PHASE>(infos.phase);
 			return TRUE;
 		}
 		arg.backup_phase = infos.phase;
@@ -2954,8 +2900,7 @@ bool field::process(Processors::ForcedBattle& arg) {
 		core.new_ochain.clear();
 		core.quick_f_chain.clear();
 		core.delayed_quick_tmp.clear();
-		auto message = pduel->new_message(MSG_NEW_PHASE);
-		message->write<uint16_t>(PHASE_BATTLE_START);
+		pduel->write_message<MSG_NEW_PHASE>(PHASE_BATTLE_START);
 		emplace_process<Processors::BattleCommand>(Step{ 1 }, nullptr, true);
 		return FALSE;
 	}
@@ -3002,8 +2947,7 @@ bool field::process(Processors::ForcedBattle& arg) {
 		if(core.mainphase_attack)
 			core.mainphase_attack = FALSE;
 		//////kdiy//////////
-		auto message = pduel->new_message(MSG_NEW_PHASE);
-		message->write<uint16_t>(infos.phase);
+		pduel->write_message<MSG_NEW_PHASE>(infos.phase);
 		return TRUE;
 	}
 	}
@@ -3042,7 +2986,7 @@ bool field::process(Processors::DamageStep& arg) {
 			message->write(loc_info{});
 		}
 		infos.phase = PHASE_DAMAGE;
-		(void)pduel->new_message(MSG_DAMAGE_STEP_START);
+		pduel->write_message<MSG_DAMAGE_STEP_START>();
 		core.pre_field[0] = core.attacker->fieldid_r;
 		++core.attacker->attacked_count;
 		if(core.attack_target) {
@@ -3620,14 +3564,10 @@ bool field::process(Processors::Turn& arg) {
 			adjust_all();
 			return FALSE;
 		}
-		auto message = pduel->new_message(MSG_NEW_PHASE);
-		message->write<uint16_t>(infos.phase);
+		pduel->write_message<MSG_NEW_PHASE>(infos.phase);
 		raise_event(nullptr, EVENT_PREDRAW, nullptr, 0, 0, turn_player, 0);
 		process_instant_event();
-		message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_EVENT);
-		message->write<uint8_t>(turn_player);
-		message->write<uint64_t>(27);
+		pduel->write_message<MSG_HINT>(HINT_EVENT, turn_player, 27);
 		if(core.new_fchain.size() || core.new_ochain.size())
 			emplace_process<Processors::PointEvent>(false, true, false);
 		/*if(core.set_forced_attack)
@@ -3669,8 +3609,7 @@ bool field::process(Processors::Turn& arg) {
 			adjust_all();
 			return FALSE;
 		}
-		auto message = pduel->new_message(MSG_NEW_PHASE);
-		message->write<uint16_t>(infos.phase);
+		pduel->write_message<MSG_NEW_PHASE>(infos.phase);
 		raise_event(nullptr, EVENT_PHASE_START + PHASE_STANDBY, nullptr, 0, 0, turn_player, 0);
 		process_instant_event();
 		/*if(core.set_forced_attack)
@@ -3705,8 +3644,7 @@ bool field::process(Processors::Turn& arg) {
 		core.new_ochain.clear();
 		core.quick_f_chain.clear();
 		core.delayed_quick_tmp.clear();
-		auto message = pduel->new_message(MSG_NEW_PHASE);
-		message->write<uint16_t>(infos.phase);
+		pduel->write_message<MSG_NEW_PHASE>(infos.phase);
 		emplace_process<Processors::IdleCommand>();
 		/*if(core.set_forced_attack)
 			emplace_process<Processors::ForcedBattle>();*/
@@ -3727,8 +3665,7 @@ bool field::process(Processors::Turn& arg) {
 		if(!core.mainphase_attack)
 		////kdiy////////
 		++core.battle_phase_count[infos.turn_player];
-		auto message = pduel->new_message(MSG_NEW_PHASE);
-		message->write<uint16_t>(infos.phase);
+		pduel->write_message<MSG_NEW_PHASE>(infos.phase);
 		// Show the texts to indicate that BP is entered and skipped
 		if(is_player_affected_by_effect(infos.turn_player, EFFECT_SKIP_BP) || core.force_turn_end) {
 			arg.step = 15;
@@ -3840,8 +3777,7 @@ bool field::process(Processors::Turn& arg) {
 		core.new_ochain.clear();
 		core.quick_f_chain.clear();
 		core.delayed_quick_tmp.clear();
-		auto message = pduel->new_message(MSG_NEW_PHASE);
-		message->write<uint16_t>(infos.phase);
+		pduel->write_message<MSG_NEW_PHASE>(infos.phase);
 		infos.can_shuffle = true;
 		emplace_process<Processors::IdleCommand>();
 		/*if(core.set_forced_attack)
@@ -3858,8 +3794,7 @@ bool field::process(Processors::Turn& arg) {
 			adjust_all();
 			return FALSE;
 		}
-		auto message = pduel->new_message(MSG_NEW_PHASE);
-		message->write<uint16_t>(infos.phase);
+		pduel->write_message<MSG_NEW_PHASE>(infos.phase);
 		raise_event(nullptr, EVENT_PHASE_START + PHASE_END, nullptr, 0, 0, turn_player, 0);
 		process_instant_event();
 		adjust_all();
@@ -4100,10 +4035,7 @@ bool field::process(Processors::AddChain& arg) {
 		int32_t playerid = clit.triggering_player;
 		effect* peffect = ch->triggering_effect;
 		card* phandler = peffect->get_handler();
-		auto message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_OPSELECTED);
-		message->write<uint8_t>(playerid);
-		message->write<uint64_t>(returns.at<int32_t>(0) >= (int32_t)core.select_options.size() ? core.select_options[returns.at<int32_t>(0)] : 65);
+		pduel->write_message<MSG_HINT>(HINT_OPSELECTED, playerid, returns.at<int32_t>(0) >= (int32_t)core.select_options.size() ? core.select_options[returns.at<int32_t>(0)] : 65);
 		clit.triggering_effect = peffect;
 		clit.evt = ch->evt;
 		phandler->create_relation(clit);
@@ -4434,8 +4366,7 @@ bool field::process(Processors::SolveChain& arg) {
 				}
 			}
 		}
-		auto message = pduel->new_message(MSG_CHAIN_SOLVING);
-		message->write<uint8_t>(cait->chain_count);
+		pduel->write_message<MSG_CHAIN_SOLVING>(cait->chain_count);
 		add_to_disable_check_list(cait->triggering_effect->get_handler());
 		adjust_instant();
 		raise_event(nullptr, EVENT_CHAIN_ACTIVATING, cait->triggering_effect, 0, cait->triggering_player, cait->triggering_player, cait->chain_count);
@@ -4497,8 +4428,7 @@ bool field::process(Processors::SolveChain& arg) {
 		if(is_chain_disablable(cait->chain_count) && (!peffect->is_flag(EFFECT_FLAG_CONTINUOUS_TARGET) || cait->replace_op)) {
 			if(is_chain_disabled(cait->chain_count) || (pcard->get_status(STATUS_DISABLED | STATUS_FORBIDDEN) && pcard->is_has_relation(*cait))) {
 				if(!(cait->flag & CHAIN_DISABLE_EFFECT)) {
-					auto message = pduel->new_message(MSG_CHAIN_DISABLED);
-					message->write<uint8_t>(cait->chain_count);
+					pduel->write_message<MSG_CHAIN_DISABLED>(cait->chain_count);
 				}
 				raise_event(nullptr, EVENT_CHAIN_DISABLED, peffect, 0, cait->triggering_player, cait->triggering_player, cait->chain_count);
 				process_instant_event();
@@ -4529,7 +4459,7 @@ bool field::process(Processors::SolveChain& arg) {
 		effect* peffect = cait->triggering_effect;
 		if(arg.backed_up_operation) {
 			if(peffect->operation != 0)
-				ensure_luaL_stack(luaL_unref, pduel->lua->lua_state, LUA_REGISTRYINDEX, peffect->operation);
+				pduel->lua->release_lua_ref(peffect->operation);
 			peffect->operation = arg.backed_up_operation;
 		}
 		core.special_summoning.clear();
@@ -4600,8 +4530,7 @@ bool field::process(Processors::SolveChain& arg) {
 		return FALSE;
 	}
 	case 10: {
-		auto message = pduel->new_message(MSG_CHAIN_SOLVED);
-		message->write<uint8_t>(cait->chain_count);
+		pduel->write_message<MSG_CHAIN_SOLVED>(cait->chain_count);
 		effect* peffect = cait->triggering_effect;
 		card* pcard = peffect->get_handler();
 		if((peffect->type & EFFECT_TYPE_ACTIVATE) && (cait->flag & CHAIN_ACTIVATING))
@@ -4660,7 +4589,7 @@ bool field::process(Processors::SolveChain& arg) {
 	}
 	case 12: {
 		core.used_event.splice(core.used_event.end(), core.point_event);
-		pduel->new_message(MSG_CHAIN_END);
+		pduel->write_message<MSG_CHAIN_END>();
 		reset_chain();
 		if((core.summoning_card || core.summoning_proc_group_type || core.effect_damage_step == 1) && core.reserved)
 			core.subunits.push_back(*std::exchange(core.reserved, std::nullopt));
@@ -4741,16 +4670,12 @@ int32_t field::break_effect(bool clear_sent) {
 			rea = 2;
 		}
 		if(winp != 5) {
-			auto message = pduel->new_message(MSG_WIN);
-			message->write<uint8_t>(winp);
-			message->write<uint8_t>(rea);
+			pduel->write_message<MSG_WIN>(winp, rea);
 			core.overdraw[0] = core.overdraw[1] = false;
 			core.win_player = 5;
 			core.win_reason = 0;
 		} else if(core.win_player != 5) {
-			auto message = pduel->new_message(MSG_WIN);
-			message->write<uint8_t>(core.win_player);
-			message->write<uint8_t>(core.win_reason);
+			pduel->write_message<MSG_WIN>(core.win_player, core.win_reason);
 			core.win_player = 5;
 			core.win_reason = 0;
 			core.overdraw[0] = core.overdraw[1] = false;
@@ -4797,8 +4722,7 @@ void field::refresh_location_info_instant() {
 	player[1].disabled_location |= (((player[0].disabled_location >> 5) & 1) << 6) | (((player[0].disabled_location >> 6) & 1) << 5);
 	uint32_t dis2 = player[0].disabled_location | (player[1].disabled_location << 16);
 	if(dis1 != dis2) {
-		auto message = pduel->new_message(MSG_FIELD_DISABLED);
-		message->write<uint32_t>(dis2);
+		pduel->write_message<MSG_FIELD_DISABLED>(dis2);
 	}
 }
 bool field::process(Processors::RefreshLoc& arg) {
@@ -4962,8 +4886,7 @@ bool field::process(Processors::RefreshLoc& arg) {
 		player[1].disabled_location |= (((player[0].disabled_location >> 5) & 1) << 6) | (((player[0].disabled_location >> 6) & 1) << 5);
 		uint32_t dis = player[0].disabled_location | (player[1].disabled_location << 16);
 		if(dis != arg.previously_disabled_locations) {
-			auto message = pduel->new_message(MSG_FIELD_DISABLED);
-			message->write<uint32_t>(dis);
+			pduel->write_message<MSG_FIELD_DISABLED>(dis);
 		}
 		return TRUE;
 	}
@@ -4974,6 +4897,7 @@ bool field::process(Processors::Adjust& arg) {
 	switch(arg.step) {
 	case 0: {
 		core.re_adjust = false;
+		++core.adjust_passes;
 		return FALSE;
 	}
 	case 1: {
@@ -5033,16 +4957,12 @@ bool field::process(Processors::Adjust& arg) {
 					}
 			}
 			if(winp != 5) {
-				auto message = pduel->new_message(MSG_WIN);
-				message->write<uint8_t>(winp);
-				message->write<uint8_t>(rea);
+				pduel->write_message<MSG_WIN>(winp, rea);
 				core.overdraw[0] = core.overdraw[1] = false;
 				core.win_player = 5;
 				core.win_reason = 0;
 			} else if(core.win_player != 5) {
-				auto message = pduel->new_message(MSG_WIN);
-				message->write<uint8_t>(core.win_player);
-				message->write<uint8_t>(core.win_reason);
+				pduel->write_message<MSG_WIN>(core.win_player, core.win_reason);
 				core.win_player = 5;
 				core.win_reason = 0;
 				core.overdraw[0] = core.overdraw[1] = false;
@@ -5072,6 +4992,10 @@ bool field::process(Processors::Adjust& arg) {
 		//trap monster
 		core.trap_monster_adjust_set[0].clear();
 		core.trap_monster_adjust_set[1].clear();
+		if(effects.disable_trapmonster_count == 0) {
+			++core.adjust_trap_monster_skipped;
+			return FALSE;
+		}
 		for(uint8_t p = 0; p < 2; ++p) {
 			for(auto& pcard : player[p].list_mzone) {
 				if(!pcard) continue;
@@ -5246,6 +5170,10 @@ bool field::process(Processors::Adjust& arg) {
 	}
 	case 11: {
 		//position
+		if(effects.set_position_count == 0) {
+			++core.adjust_position_skipped;
+			return FALSE;
+		}
 		uint32_t tp = infos.turn_player, pos;
 		card_set pos_adjust;
 		effect_set eset;
@@ -5336,7 +5264,7 @@ bool field::process(Processors::Adjust& arg) {
 			if(std::exchange(core.deck_reversed, reversed) != reversed) {
 				reverse_deck(0);
 				reverse_deck(1);
-				pduel->new_message(MSG_REVERSE_DECK);
+				pduel->write_message<MSG_REVERSE_DECK>();
 				if(reversed) {
 					if(player[0].list_main.size()) {
 						card* ptop = player[0].list_main.back();
@@ -5549,13 +5477,7 @@ bool field::process(Processors::DiscardHand& arg) {
 	auto reason = arg.reason;
 	switch(arg.step) {
 	case 0: {
-		auto message = pduel->new_message(MSG_HINT);
-		message->write<uint8_t>(HINT_SELECTMSG);
-		message->write<uint8_t>(playerid);
-		if(reason & REASON_DISCARD)
-			message->write<uint64_t>(501);
-		else
-			message->write<uint64_t>(504);
+		pduel->write_message<MSG_HINT>(HINT_SELECTMSG, playerid, (reason & REASON_DISCARD) ? 501 : 504);
 		emplace_process<Processors::SelectCard>(playerid, false, min, max);
 		return FALSE;
 	}
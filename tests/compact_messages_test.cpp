@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2026, Edoardo Lolletti (edo9300) <edoardo762@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+/*
+	Plays the same synthetic duels with and without DUEL_COMPACT_MESSAGES and checks that
+	Messages::CompactStreamDecoder gives back the messages of the plain buffers, also across
+	OCG_DuelReset, then feeds the decoder corrupted and random streams. Prints the size
+	of the messages in both forms.
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "../ocgapi_messages.h"
+#include "test_duel.h"
+
+namespace {
+
+using message_list = std::vector<std::vector<uint8_t>>;
+
+message_list read_plain(OCG_Duel duel, size_t& bytes) {
+	uint32_t length;
+	auto* buffer = OCG_DuelGetMessage(duel, &length);
+	bytes += length;
+	message_list messages;
+	for(const auto& view : Messages::MessageBuffer(buffer, length))
+		messages.emplace_back(view.data(), view.data() + view.length());
+	return messages;
+}
+
+message_list read_compact(OCG_Duel duel, Messages::CompactStreamDecoder& decoder, std::vector<uint8_t>& stream) {
+	uint32_t length;
+	auto* buffer = static_cast<const uint8_t*>(OCG_DuelGetMessage(duel, &length));
+	stream.insert(stream.end(), buffer, buffer + length);
+	message_list messages;
+	TEST_CHECK(decoder.decode(buffer, length, [&messages](Messages::MessageView view) {
+		messages.emplace_back(view.data(), view.data() + view.length());
+	}));
+	return messages;
+}
+
+// plays both duels until they're won, the compact stream is appended to stream and has to be
+// decodable as a whole by a new decoder
+void check_round_trip(OCG_Duel plain, OCG_Duel compact, Messages::CompactStreamDecoder& decoder,
+					  std::vector<uint8_t>& stream, size_t& plain_bytes) {
+	message_list all_messages;
+	for(bool won = false; !won;) {
+		const int status = OCG_DuelProcess(plain);
+		TEST_CHECK(status != OCG_DUEL_STATUS_END && OCG_DuelProcess(compact) == status);
+		const auto messages = read_plain(plain, plain_bytes);
+		TEST_CHECK(!messages.empty() && read_compact(compact, decoder, stream) == messages);
+		all_messages.insert(all_messages.end(), messages.begin(), messages.end());
+		for(const auto& message : messages)
+			won |= Messages::MessageView(message.data(), static_cast<uint32_t>(message.size())).is<Messages::WIN>();
+		if(!won && status == OCG_DUEL_STATUS_AWAITING)
+			TEST_CHECK(test::respond(plain, messages.back()[0]) && test::respond(compact, messages.back()[0]));
+	}
+	Messages::CompactStreamDecoder new_decoder;
+	message_list decoded;
+	TEST_CHECK(new_decoder.decode(stream.data(), static_cast<uint32_t>(stream.size()), [&decoded](Messages::MessageView view) {
+		decoded.emplace_back(view.data(), view.data() + view.length());
+	}));
+	TEST_CHECK(decoded == all_messages);
+}
+
+// a malformed stream has to be rejected without reading outside of it
+void check_malformed(const std::vector<uint8_t>& stream, std::mt19937_64& rng) {
+	for(int i = 0; i < 2000; ++i) {
+		auto corrupted = stream;
+		for(auto flips = rng() % 4 + 1; flips != 0; --flips)
+			corrupted[rng() % corrupted.size()] ^= static_cast<uint8_t>(1u << (rng() % 8));
+		Messages::CompactStreamDecoder decoder;
+		decoder.decode(corrupted.data(), static_cast<uint32_t>(corrupted.size()), [](Messages::MessageView) {});
+		std::vector<uint8_t> random(rng() % 256);
+		for(auto& byte : random)
+			byte = static_cast<uint8_t>(rng());
+		decoder.decode(random.data(), static_cast<uint32_t>(random.size()), [](Messages::MessageView) {});
+	}
+}
+
+}
+
+int main() {
+	// bigger decks would need to answer the discards for the hand size limit
+	constexpr uint32_t deck_size = 6;
+	auto* plain = test::create_duel(0, 1, deck_size);
+	auto* compact = test::create_duel(test::duel_compact_messages, 1, deck_size);
+	Messages::CompactStreamDecoder decoder;
+	std::vector<uint8_t> stream;
+	size_t plain_bytes = 0;
+	check_round_trip(plain, compact, decoder, stream, plain_bytes);
+	// the duels are reset to play more of them, each reset starts a new stream
+	size_t compact_bytes = stream.size();
+	for(uint64_t seed = 2; seed <= 16; ++seed) {
+		auto options = test::make_options(0, seed);
+		TEST_CHECK(OCG_DuelReset(plain, &options) == OCG_DUEL_CREATION_SUCCESS);
+		options.flags = test::duel_compact_messages;
+		TEST_CHECK(OCG_DuelReset(compact, &options) == OCG_DUEL_CREATION_SUCCESS);
+		test::start_duel(plain, deck_size);
+		test::start_duel(compact, deck_size);
+		decoder.reset();
+		std::vector<uint8_t> reset_stream;
+		check_round_trip(plain, compact, decoder, reset_stream, plain_bytes);
+		compact_bytes += reset_stream.size();
+	}
+	std::printf("%zu bytes of messages, %zu with DUEL_COMPACT_MESSAGES (%.1f%%)\n", plain_bytes, compact_bytes,
+				100.0 * static_cast<double>(compact_bytes) / static_cast<double>(plain_bytes));
+	std::mt19937_64 rng(1);
+	check_malformed(stream, rng);
+	OCG_DestroyDuel(compact);
+	OCG_DestroyDuel(plain);
+	return 0;
+}
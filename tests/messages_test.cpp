@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2026, Edoardo Lolletti (edo9300) <edoardo762@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+/*
+	Checks the readers of ocgapi_messages.h against the way the core writes the messages:
+	every schema is written with random values through Messages::write_fields, as duel::write_message
+	does, and read back with MessageView, MessageBuffer is fed random buffers, and the messages
+	of a synthetic duel with a schema are checked to have the size it declares.
+*/
+
+#include <cstdint>
+#include <cstring> //std::memcpy
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "../ocgapi_messages.h"
+#include "test_duel.h"
+
+namespace {
+
+// same interface as duel::duel_message
+struct test_message {
+	std::vector<uint8_t> data;
+	template<typename T>
+	void write(T value) {
+		const auto* ptr = reinterpret_cast<const uint8_t*>(&value);
+		data.insert(data.end(), ptr, ptr + sizeof(T));
+	}
+};
+
+template<uint8_t message, size_t... index>
+void check_round_trip(std::mt19937_64& rng, std::index_sequence<index...>) {
+	using fields = Messages::field_t<message>;
+	const fields values{ static_cast<std::tuple_element_t<index, fields>>(rng())... };
+	test_message pmessage{ { message } };
+	Messages::write_fields<message>(pmessage, std::index_sequence<index...>{}, std::get<index>(values)...);
+	const auto size = static_cast<uint32_t>(pmessage.data.size());
+	TEST_CHECK(Messages::MessageView(pmessage.data.data(), size).is<message>());
+	TEST_CHECK(((Messages::MessageView(pmessage.data.data(), size).get<message, index>() == std::get<index>(values)) && ...));
+	pmessage.data.push_back(0);
+	TEST_CHECK(!Messages::MessageView(pmessage.data.data(), size + 1).is<message>());
+	TEST_CHECK(!Messages::MessageView(pmessage.data.data(), size - 1).is<message>());
+}
+
+template<uint8_t... message>
+void check_round_trips(std::mt19937_64& rng) {
+	(check_round_trip<message>(rng, std::make_index_sequence<Messages::Schema<message>::count>{}), ...);
+}
+
+template<uint8_t... message>
+size_t schema_size(uint8_t type) {
+	size_t size = 0;
+	((size = type == message ? 1 + Messages::Schema<message>::size : size), ...);
+	return size;
+}
+
+constexpr auto schema_size_of = schema_size<Messages::HINT, Messages::WIN, Messages::SHUFFLE_DECK, Messages::REVERSE_DECK,
+	Messages::NEW_PHASE, Messages::FIELD_DISABLED, Messages::SUMMONED, Messages::SPSUMMONED, Messages::FLIPSUMMONED,
+	Messages::CHAIN_SOLVING, Messages::CHAIN_SOLVED, Messages::CHAIN_END, Messages::CHAIN_NEGATED, Messages::CHAIN_DISABLED,
+	Messages::DAMAGE, Messages::RECOVER, Messages::LPUPDATE, Messages::PAY_LPCOST, Messages::ATTACK_DISABLED,
+	Messages::DAMAGE_STEP_START, Messages::DAMAGE_STEP_END>;
+
+void check_buffer_iteration(std::mt19937_64& rng) {
+	for(int i = 0; i < 10000; ++i) {
+		// length prefixes are mostly small, so that the random buffers also hold whole messages
+		std::vector<uint8_t> buffer(rng() % 64);
+		for(auto& byte : buffer)
+			byte = static_cast<uint8_t>(rng() % 4 == 0 ? rng() : rng() % 8);
+		const auto* end = buffer.data() + buffer.size();
+		const auto* expected = buffer.data();
+		for(const auto& view : Messages::MessageBuffer(buffer.data(), static_cast<uint32_t>(buffer.size()))) {
+			TEST_CHECK(view.data() == expected + sizeof(uint32_t) && view.length() <= static_cast<size_t>(end - view.data()));
+			expected = view.data() + view.length();
+		}
+		// the iteration only stops early on a truncated message
+		TEST_CHECK(static_cast<size_t>(end - expected) < sizeof(uint32_t) || [&] {
+			uint32_t length;
+			std::memcpy(&length, expected, sizeof(length));
+			return length > static_cast<size_t>(end - expected) - sizeof(uint32_t);
+		}());
+	}
+}
+
+void check_duel_messages() {
+	auto* duel = test::create_duel(0, 1);
+	size_t checked = 0;
+	// the core keeps processing after a duel is won, hosts stop at MSG_WIN
+	for(bool won = false; !won;) {
+		const int status = OCG_DuelProcess(duel);
+		TEST_CHECK(status != OCG_DUEL_STATUS_END);
+		uint32_t length;
+		auto* buffer = OCG_DuelGetMessage(duel, &length);
+		uint8_t last = 0;
+		uint32_t read = 0;
+		for(const auto& view : Messages::MessageBuffer(buffer, length)) {
+			if(const auto size = schema_size_of(view.type()); size != 0) {
+				TEST_CHECK(view.length() == size);
+				++checked;
+			}
+			last = view.type();
+			won |= view.is<Messages::WIN>();
+			read += sizeof(uint32_t) + view.length();
+		}
+		TEST_CHECK(read == length);
+		if(!won && status == OCG_DUEL_STATUS_AWAITING)
+			TEST_CHECK(test::respond(duel, last));
+	}
+	TEST_CHECK(checked != 0);
+	OCG_DestroyDuel(duel);
+}
+
+}
+
+int main() {
+	std::mt19937_64 rng(1);
+	for(int i = 0; i < 1000; ++i) {
+		check_round_trips<Messages::HINT, Messages::WIN, Messages::SHUFFLE_DECK, Messages::REVERSE_DECK,
+			Messages::NEW_PHASE, Messages::FIELD_DISABLED, Messages::SUMMONED, Messages::SPSUMMONED, Messages::FLIPSUMMONED,
+			Messages::CHAIN_SOLVING, Messages::CHAIN_SOLVED, Messages::CHAIN_END, Messages::CHAIN_NEGATED, Messages::CHAIN_DISABLED,
+			Messages::DAMAGE, Messages::RECOVER, Messages::LPUPDATE, Messages::PAY_LPCOST, Messages::ATTACK_DISABLED,
+			Messages::DAMAGE_STEP_START, Messages::DAMAGE_STEP_END>(rng);
+	}
+	check_buffer_iteration(rng);
+	check_duel_messages();
+	return 0;
+}
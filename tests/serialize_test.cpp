@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2026, Edoardo Lolletti (edo9300) <edoardo762@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+/*
+	Restores a duel created with DUEL_SERIALIZABLE and DUEL_COMPACT_MESSAGES in the middle of a turn,
+	and checks that a new decoder reads the buffer left by the restore and the following ones
+	as the decoder of the original duel reads the same buffers.
+*/
+
+#include <cstdint>
+#include <vector>
+#include "../ocgapi_messages.h"
+#include "test_duel.h"
+
+namespace {
+
+using message_list = std::vector<std::vector<uint8_t>>;
+
+message_list decode_pending(OCG_Duel duel, Messages::CompactStreamDecoder& decoder) {
+	uint32_t length;
+	auto* buffer = OCG_DuelGetMessage(duel, &length);
+	message_list messages;
+	TEST_CHECK(decoder.decode(buffer, length, [&messages](Messages::MessageView view) {
+		messages.emplace_back(view.data(), view.data() + view.length());
+	}));
+	return messages;
+}
+
+}
+
+int main() {
+	auto* duel = test::create_duel(test::duel_serializable | test::duel_compact_messages, 1);
+	Messages::CompactStreamDecoder decoder;
+	message_list pending;
+	// plays a few prompts first, so that the encoder of the duel has a history
+	for(int prompts = 0; prompts < 4;) {
+		const int status = OCG_DuelProcess(duel);
+		pending = decode_pending(duel, decoder);
+		TEST_CHECK(status != OCG_DUEL_STATUS_END && !pending.empty());
+		if(status == OCG_DUEL_STATUS_AWAITING && ++prompts < 4)
+			TEST_CHECK(test::respond(duel, pending.back()[0]));
+	}
+	uint32_t length;
+	auto* buffer = static_cast<const uint8_t*>(OCG_DuelSerialize(duel, &length));
+	TEST_CHECK(buffer != nullptr);
+	const std::vector<uint8_t> journal(buffer, buffer + length);
+	const auto options = test::make_options(0, 0);
+	OCG_Duel restored = nullptr;
+	TEST_CHECK(OCG_DuelDeserialize(&restored, &options, journal.data(), length) == OCG_DUEL_CREATION_SUCCESS);
+	Messages::CompactStreamDecoder restored_decoder;
+	TEST_CHECK(decode_pending(restored, restored_decoder) == pending);
+	for(int i = 0; i < 4; ++i) {
+		const auto prompt = pending.back()[0];
+		TEST_CHECK(test::respond(duel, prompt) && test::respond(restored, prompt));
+		const int status = OCG_DuelProcess(duel);
+		TEST_CHECK(OCG_DuelProcess(restored) == status);
+		pending = decode_pending(duel, decoder);
+		TEST_CHECK(!pending.empty() && decode_pending(restored, restored_decoder) == pending);
+		if(status != OCG_DUEL_STATUS_AWAITING)
+			break;
+	}
+	OCG_DestroyDuel(restored);
+	OCG_DestroyDuel(duel);
+	return 0;
+}
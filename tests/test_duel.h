@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2026, Edoardo Lolletti (edo9300) <edoardo762@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#ifndef TEST_DUEL_H
+#define TEST_DUEL_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include "../ocgapi.h"
+
+/*
+	Synthetic duels for the tests: no card database nor scripts are available, so both decks are
+	made of a few blank cards, and the players always pass to the end phase until a deck out.
+*/
+namespace test {
+
+// values of common.h, that is internal to the core
+constexpr uint8_t msg_select_battlecmd = 10;
+constexpr uint8_t msg_select_idlecmd = 11;
+constexpr uint8_t msg_select_chain = 16;
+constexpr uint64_t duel_serializable = 0x4000000000;
+constexpr uint64_t duel_compact_messages = 0x10000000000;
+
+#define TEST_CHECK(cond) do { \
+	if(!(cond)) { \
+		std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+		std::exit(1); \
+	} \
+} while(0)
+
+inline OCG_DuelOptions make_options(uint64_t flags, uint64_t seed) {
+	static uint16_t blank_setcodes[] = { 0 };
+	OCG_DuelOptions options{};
+	options.seed[0] = seed;
+	options.seed[1] = seed ^ 0x9e3779b97f4a7c15;
+	options.seed[2] = ~seed;
+	options.seed[3] = seed * 0xbf58476d1ce4e5b9 + 1;
+	options.flags = flags;
+	options.team1 = { 8000, 0, 1 };
+	options.team2 = { 8000, 0, 1 };
+	options.cardReader = [](void* /*payload*/, uint32_t code, OCG_CardData* data) {
+		*data = OCG_CardData{};
+		data->code = code;
+		data->setcodes = blank_setcodes;
+	};
+	options.scriptReader = [](void* /*payload*/, OCG_Duel /*duel*/, const char* /*name*/) { return 0; };
+	options.logHandler = [](void* /*payload*/, const char* /*string*/, int /*type*/) {};
+	options.cardReaderDone = [](void* /*payload*/, OCG_CardData* /*data*/) {};
+	return options;
+}
+
+// adds the decks to a duel just created or reset and starts it
+inline void start_duel(OCG_Duel duel, uint32_t deck_size = 5) {
+	constexpr uint32_t location_deck = 0x01;
+	constexpr uint32_t pos_facedown_defense = 0x8;
+	for(uint8_t team = 0; team < 2; ++team) {
+		for(uint32_t i = 0; i < deck_size; ++i) {
+			OCG_NewCardInfo info{ team, 0, 1000 + i, team, location_deck, 0, pos_facedown_defense };
+			OCG_DuelNewCard(duel, &info);
+		}
+	}
+	OCG_StartDuel(duel);
+}
+
+inline OCG_Duel create_duel(uint64_t flags, uint64_t seed, uint32_t deck_size = 5) {
+	auto options = make_options(flags, seed);
+	OCG_Duel duel = nullptr;
+	TEST_CHECK(OCG_CreateDuel(&duel, &options) == OCG_DUEL_CREATION_SUCCESS);
+	start_duel(duel, deck_size);
+	return duel;
+}
+
+// answers the prompts of the synthetic duels, going to the end phase and never chaining,
+// returns false for any other message
+inline bool respond(OCG_Duel duel, uint8_t prompt) {
+	int32_t response;
+	if(prompt == msg_select_idlecmd)
+		response = 7;
+	else if(prompt == msg_select_battlecmd)
+		response = 3;
+	else if(prompt == msg_select_chain)
+		response = -1;
+	else
+		return false;
+	OCG_DuelSetResponse(duel, &response, sizeof(response));
+	return true;
+}
+
+}
+
+#endif /* TEST_DUEL_H */
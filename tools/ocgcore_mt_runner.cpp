@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2026, Edoardo Lolletti (edo9300) <edoardo762@gmail.com>
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+/*
+	Runs the same set of duels with an increasing number of worker threads, each thread taking
+	the next duel from a shared queue, and reports the throughput of each run.
+	Every duel is hashed (all its messages and the final field query) and the hashes of every run
+	are compared against the single threaded one, so that the run fails if running duels concurrently
+	changed any of them.
+	The duels are either replays of journals recorded with DUEL_SERIALIZABLE, passed as arguments,
+	or, if none is passed, synthetic duels with small decks of blank cards.
+	No card database is available, so cards only have their code and card scripts are read
+	from the directory passed with -s if any.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../ocgapi.h"
+
+namespace {
+
+// constants of common.h, that is internal to the core
+constexpr uint8_t MSG_WIN = 5;
+constexpr uint8_t MSG_SELECT_BATTLECMD = 10;
+constexpr uint8_t MSG_SELECT_IDLECMD = 11;
+constexpr uint8_t MSG_SELECT_CHAIN = 16;
+constexpr uint32_t LOCATION_DECK = 0x01;
+constexpr uint32_t POS_FACEDOWN_DEFENSE = 0x8;
+constexpr uint32_t synthetic_deck_size = 5;
+
+struct runner_options {
+	uint32_t max_threads{ std::max(1u, std::min(64u, std::thread::hardware_concurrency())) };
+	uint32_t duels{ 64 };
+	std::string script_dir;
+	std::vector<std::vector<uint8_t>> journals;
+};
+
+struct fnv_hash {
+	uint64_t value{ 0xcbf29ce484222325 };
+	void update(const void* data, size_t length) {
+		auto* ptr = static_cast<const uint8_t*>(data);
+		for(size_t i = 0; i < length; ++i) {
+			value ^= ptr[i];
+			value *= 0x100000001b3;
+		}
+	}
+};
+
+uint16_t blank_setcodes[] = { 0 };
+
+void read_card(void* /*payload*/, uint32_t code, OCG_CardData* data) {
+	*data = OCG_CardData{};
+	data->code = code;
+	data->setcodes = blank_setcodes;
+}
+
+int read_script(void* payload, OCG_Duel duel, const char* name) {
+	const auto& dir = *static_cast<const std::string*>(payload);
+	if(dir.empty())
+		return 0;
+	std::ifstream file(dir + "/" + name, std::ios::binary);
+	if(!file)
+		return 0;
+	const std::string script{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+	return OCG_LoadScript(duel, script.data(), static_cast<uint32_t>(script.size()), name);
+}
+
+OCG_DuelOptions make_options(const runner_options& options, uint64_t seed) {
+	OCG_DuelOptions duel_options{};
+	duel_options.seed[0] = seed;
+	duel_options.seed[1] = seed ^ 0x9e3779b97f4a7c15;
+	duel_options.seed[2] = ~seed;
+	duel_options.seed[3] = seed * 0xbf58476d1ce4e5b9 + 1;
+	duel_options.team1 = { 8000, 0, 1 };
+	duel_options.team2 = { 8000, 0, 1 };
+	duel_options.cardReader = read_card;
+	duel_options.scriptReader = read_script;
+	duel_options.payload2 = const_cast<std::string*>(&options.script_dir);
+	duel_options.logHandler = [](void* /*payload*/, const char* /*string*/, int /*type*/) {};
+	duel_options.cardReaderDone = [](void* /*payload*/, OCG_CardData* /*data*/) {};
+	return duel_options;
+}
+
+// hashes the pending messages and returns the type of the last one, or MSG_WIN if the duel was won
+uint8_t consume_messages(OCG_Duel duel, fnv_hash& hash) {
+	uint32_t length;
+	auto* buffer = static_cast<const uint8_t*>(OCG_DuelGetMessage(duel, &length));
+	hash.update(buffer, length);
+	uint8_t last = 0;
+	for(uint32_t pos = 0; length - pos > sizeof(uint32_t);) {
+		uint32_t size;
+		std::memcpy(&size, buffer + pos, sizeof(size));
+		pos += sizeof(size);
+		if(size == 0 || size > length - pos)
+			break;
+		last = buffer[pos];
+		pos += size;
+		if(last == MSG_WIN)
+			break;
+	}
+	return last;
+}
+
+bool is_handled_prompt(uint8_t message) {
+	return message == MSG_SELECT_IDLECMD || message == MSG_SELECT_BATTLECMD || message == MSG_SELECT_CHAIN;
+}
+
+int32_t prompt_response(uint8_t message) {
+	if(message == MSG_SELECT_IDLECMD)
+		return 7;
+	if(message == MSG_SELECT_BATTLECMD)
+		return 3;
+	return -1;
+}
+
+// runs the duel until it's won, always passing to the end phase without chaining, stops at any other prompt
+// (the core keeps processing after a duel is won, it only returns OCG_DUEL_STATUS_END on errors)
+void drive_duel(OCG_Duel duel, fnv_hash& hash) {
+	// a replayed duel can be left waiting for the response to its last messages
+	uint8_t last = consume_messages(duel, hash);
+	int status = is_handled_prompt(last) ? OCG_DUEL_STATUS_AWAITING : OCG_DUEL_STATUS_CONTINUE;
+	for(uint32_t responses = 0; responses < 10000 && last != MSG_WIN;) {
+		if(status == OCG_DUEL_STATUS_AWAITING) {
+			if(!is_handled_prompt(last))
+				break;
+			const int32_t response = prompt_response(last);
+			OCG_DuelSetResponse(duel, &response, sizeof(response));
+			++responses;
+		}
+		status = OCG_DuelProcess(duel);
+		last = consume_messages(duel, hash);
+		if(status == OCG_DUEL_STATUS_END)
+			break;
+	}
+	uint32_t length;
+	auto* field = OCG_DuelQueryField(duel, &length);
+	hash.update(field, length);
+}
+
+uint64_t run_duel(const runner_options& options, uint32_t index) {
+	fnv_hash hash;
+	OCG_Duel duel = nullptr;
+	auto duel_options = make_options(options, index + 1);
+	if(!options.journals.empty()) {
+		const auto& journal = options.journals[index % options.journals.size()];
+		if(OCG_DuelDeserialize(&duel, &duel_options, journal.data(), static_cast<uint32_t>(journal.size())) != OCG_DUEL_CREATION_SUCCESS)
+			return 0;
+	} else {
+		if(OCG_CreateDuel(&duel, &duel_options) != OCG_DUEL_CREATION_SUCCESS)
+			return 0;
+		for(uint8_t team = 0; team < 2; ++team) {
+			for(uint32_t i = 0; i < synthetic_deck_size; ++i) {
+				OCG_NewCardInfo info{ team, 0, 1000 + i, team, LOCATION_DECK, 0, POS_FACEDOWN_DEFENSE };
+				OCG_DuelNewCard(duel, &info);
+			}
+		}
+		OCG_StartDuel(duel);
+	}
+	drive_duel(duel, hash);
+	OCG_DestroyDuel(duel);
+	return hash.value;
+}
+
+std::vector<uint64_t> run_all(const runner_options& options, uint32_t threads) {
+	std::vector<uint64_t> hashes(options.duels);
+	std::atomic<uint32_t> next{ 0 };
+	std::vector<std::thread> workers;
+	for(uint32_t i = 0; i < threads; ++i) {
+		workers.emplace_back([&] {
+			for(uint32_t index; (index = next++) < options.duels;)
+				hashes[index] = run_duel(options, index);
+		});
+	}
+	for(auto& worker : workers)
+		worker.join();
+	return hashes;
+}
+
+bool parse_options(int argc, char* argv[], runner_options& options) {
+	for(int i = 1; i < argc; ++i) {
+		const std::string arg = argv[i];
+		if((arg == "-t" || arg == "-n" || arg == "-s") && i + 1 < argc) {
+			const char* value = argv[++i];
+			if(arg == "-s")
+				options.script_dir = value;
+			else if(arg == "-t")
+				options.max_threads = std::max(1, std::atoi(value));
+			else
+				options.duels = std::max(1, std::atoi(value));
+			continue;
+		}
+		if(arg[0] == '-')
+			return false;
+		std::ifstream file(arg, std::ios::binary);
+		if(!file) {
+			std::fprintf(stderr, "can't open %s\n", arg.data());
+			return false;
+		}
+		options.journals.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+	return true;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+	runner_options options;
+	if(!parse_options(argc, argv, options)) {
+		std::fprintf(stderr, "usage: %s [-t max threads] [-n duels] [-s script directory] [journal...]\n", argv[0]);
+		return 2;
+	}
+	std::vector<uint64_t> reference;
+	double reference_time = 0;
+	bool failed = false;
+	for(uint32_t threads = 1;; threads = std::min(threads * 2, options.max_threads)) {
+		const auto start = std::chrono::steady_clock::now();
+		const auto hashes = run_all(options, threads);
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		if(threads == 1) {
+			reference = hashes;
+			reference_time = elapsed.count();
+			if(std::count(reference.begin(), reference.end(), 0) != 0) {
+				std::fprintf(stderr, "some duels couldn't be created\n");
+				return 1;
+			}
+		}
+		const auto mismatches = options.duels - std::inner_product(hashes.begin(), hashes.end(), reference.begin(), 0u,
+																  std::plus<>(), std::equal_to<>());
+		std::printf("%2u threads: %u duels in %.3fs, %.1f duels/s, speedup %.2fx%s\n", threads, options.duels,
+					elapsed.count(), options.duels / elapsed.count(), reference_time / elapsed.count(),
+					mismatches != 0 ? ", RESULTS DIFFER FROM THE SINGLE THREADED RUN" : "");
+		failed |= mismatches != 0;
+		if(threads == options.max_threads)
+			break;
+	}
+	return failed ? 1 : 0;
+}